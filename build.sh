@@ -18,12 +18,42 @@ fi
 if [ "$1" = "clean" ]; then
   emmake make -C doomgeneric -f Makefile.pdfjs clean
 fi
-emmake make -C doomgeneric -f Makefile.pdfjs -j$(nproc --all)
+
+# MIN_WAD=1 ./build.sh leaves out the lumps this build never uses,
+# such as sounds and music (wadmin.py, "make minwad").
+WAD=doomgeneric/doom1.wad
+if [ "$MIN_WAD" = "1" ]; then
+  make -C doomgeneric -f Makefile.pdfjs minwad MINWAD="$PWD/out/min/doom1.wad"
+  WAD=out/min/doom1.wad
+fi
+
+# PACK_WAD=1 ./build.sh compresses the lumps of doom1.wad with
+# wadpack.py first; the engine decompresses each lump when it is used.
+if [ "$PACK_WAD" = "1" ]; then
+  mkdir -p out/packed
+  python3 doomgeneric/wadpack.py "$WAD" out/packed/doom1.wad
+  WAD=out/packed/doom1.wad
+fi
+
+# EMBED_IWAD=1 ./build.sh links doom1.wad into the program, where its
+# lumps are used in place, instead of base64-encoding it into the JS.
+# Run "./build.sh clean" when switching between the two.
+if [ "$EMBED_IWAD" = "1" ]; then
+  emmake make -C doomgeneric -f Makefile.pdfjs -j$(nproc --all) EMBED_IWAD="$PWD/$WAD"
+else
+  emmake make -C doomgeneric -f Makefile.pdfjs -j$(nproc --all)
+fi
 
 mkdir -p out
 cp web/* out/
 
-python3 embed_file.py file_template.js doomgeneric/doom1.wad out/data.js
+if [ "$EMBED_IWAD" = "1" ]; then
+  cat pre.js file_template.js doomgeneric/doomgeneric.js > out/compiled.js
+  python3 generate.py out/compiled.js out/doom.pdf
+  exit 0
+fi
+
+python3 embed_file.py file_template.js "$WAD" out/data.js
 cat pre.js out/data.js doomgeneric/doomgeneric.js > out/compiled.js
 cat pre.js file_template.js doomgeneric/doomgeneric.js > out/compiled_nowad.js
 
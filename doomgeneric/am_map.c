@@ -199,7 +199,7 @@ static int 	leveljuststarted = 1; 	// kluge until AM_LevelInit() is called
 
 boolean    	automapactive = false;
 static int 	finit_width = SCREENWIDTH;
-static int 	finit_height = SCREENHEIGHT - 32;
+static int 	finit_height = SCREENHEIGHT - SCREENCOORD(32);
 
 // location of window on screen
 static int 	f_x;
@@ -1322,8 +1322,9 @@ void AM_drawMarks(void)
 	    h = 6; // because something's wrong with the wad, i guess
 	    fx = CXMTOF(markpoints[i].x);
 	    fy = CYMTOF(markpoints[i].y);
-	    if (fx >= f_x && fx <= f_w - w && fy >= f_y && fy <= f_h - h)
-		V_DrawPatch(fx, fy, marknums[i]);
+	    if (fx >= f_x && fx <= f_w - SCREENCOORD(w)
+	     && fy >= f_y && fy <= f_h - SCREENCOORD(h))
+		V_DrawPatch(fx << LOWRES, fy << LOWRES, marknums[i]);
 	}
     }
 
@@ -76,6 +76,10 @@ int gametic;
 
 boolean singletics = false;
 
+// Tics run per presented frame, set by the frame pacing in d_main.c.
+
+int ticbatch = 1;
+
 // Index of the local player.
 
 static int localplayer;
@@ -157,14 +161,14 @@ static boolean BuildNewTic(void)
     if (new_sync)
     {
        // If playing single player, do not allow tics to buffer
-       // up very far
+       // up very far, unless a slow display batches them
 
-       if (!net_client_connected && maketic - gameticdiv > 2)
+       if (!net_client_connected && maketic - gameticdiv > ticbatch + 1)
            return false;
 
-       // Never go more than ~200ms ahead
+       // Never go more than ~200ms ahead, or one batch
 
-       if (maketic - gameticdiv > 8)
+       if (maketic - gameticdiv > 8 && maketic - gameticdiv > ticbatch + 1)
            return false;
     }
     else
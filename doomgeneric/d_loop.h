@@ -77,5 +77,9 @@ void D_StartNetGame(net_gamesettings_t *settings,
 extern boolean singletics;
 extern int gametic, ticdup;
 
+// Tics run per presented frame; single player may build this many
+// tics ahead (plus one) so a slow display does not lose game time.
+extern int ticbatch;
+
 #endif
 
@@ -69,10 +69,14 @@
 #include "net_query.h"
 
 #include "p_setup.h"
+#include "p_statehash.h"
 #include "r_local.h"
 #include "statdump.h"
 
 #include "d_main.h"
+#include "i_profile.h"
+
+#include "doomgeneric.h"
 
 //
 // D-DoomLoop()
@@ -186,8 +190,12 @@ void display_wipe() {
     wipestart = nowtime;
     done = wipe_ScreenWipe(wipe_Melt, 0, 0, SCREENWIDTH, SCREENHEIGHT, tics);
     I_UpdateNoBlit ();
+    PROFILE_BEGIN(PROF_MENU);
     M_Drawer ();                            // menu is drawn even on top of wipes
+    PROFILE_END(PROF_MENU);
+    PROFILE_BEGIN(PROF_FINISHUPDATE);
     I_FinishUpdate ();                      // page flip or blit buffer
+    PROFILE_END(PROF_FINISHUPDATE);
 
     if (!done) return;
     wipe_active = false;
@@ -242,12 +250,14 @@ void D_Display (void)
 			break;
 		if (automapactive)
 			AM_Drawer ();
-		if (wipe || (viewheight != 200 && fullscreen) )
+		if (wipe || (viewheight != SCREENHEIGHT && fullscreen) )
 			redrawsbar = true;
 		if (inhelpscreensstate && !inhelpscreens)
 			redrawsbar = true;              // just put away the help screen
-		ST_Drawer (viewheight == 200, redrawsbar );
-		fullscreen = viewheight == 200;
+		PROFILE_BEGIN(PROF_STATUSBAR);
+		ST_Drawer (viewheight == SCREENHEIGHT, redrawsbar );
+		PROFILE_END(PROF_STATUSBAR);
+		fullscreen = viewheight == SCREENHEIGHT;
 		break;
 
       case GS_INTERMISSION:
@@ -285,7 +295,7 @@ void D_Display (void)
     }
 
     // see if the border needs to be updated to the screen
-    if (gamestate == GS_LEVEL && !automapactive && scaledviewwidth != 320)
+    if (gamestate == GS_LEVEL && !automapactive && scaledviewwidth != SCREENWIDTH)
     {
 		if (menuactive || menuactivestate || !viewactivestate)
 			borderdrawcount = 3;
@@ -314,21 +324,25 @@ void D_Display (void)
 		if (automapactive)
 			y = 4;
 		else
-			y = viewwindowy+4;
-		V_DrawPatchDirect(viewwindowx + (scaledviewwidth - 68) / 2, y,
+			y = (viewwindowy << LOWRES)+4;
+		V_DrawPatchDirect(((viewwindowx << LOWRES) + ((scaledviewwidth << LOWRES) - 68) / 2), y,
 							  W_CacheLumpName (DEH_String("M_PAUSE"), PU_CACHE));
     }
 
 
     // menus go directly to the screen
+    PROFILE_BEGIN(PROF_MENU);
     M_Drawer ();          // menu is drawn even on top of everything
+    PROFILE_END(PROF_MENU);
     NetUpdate ();         // send out any new accumulation
 
 
     // normal update
     if (!wipe)
     {
+	PROFILE_BEGIN(PROF_FINISHUPDATE);
 	I_FinishUpdate ();              // page flip or blit buffer
+	PROFILE_END(PROF_FINISHUPDATE);
 	return;
     }
 
@@ -409,8 +423,116 @@ boolean D_GrabMouseCallback(void)
     return (gamestate == GS_LEVEL) && !demoplayback && !advancedemo;
 }
 
+//
+// Frame pacing
+//
+// doomgeneric_Tick is called as often as the platform allows. Decide
+// before drawing whether this call presents a frame: only if a batch
+// of tics has run since the last one, and not before the next frame
+// is due less the measured cost of drawing one. Other calls only run
+// tics.
+//
+
+framestats_t framestats = { 0, 0, 0, 0, 1 };
+
+static int last_present_tic = -1;
+static int next_present_ms;
+static int present_cost_ms;
+
+// The live clock can be a call out to the platform, so it is read
+// once as a batch of tics starts, once after it and once after each
+// presented frame, rather than around every tic.
+
+static boolean batch_started;
+static int batch_start_ms;
+
+void D_StartTic(void)
+{
+    // from the first tic, not from TryRunTics, which may first wait
+    // for a tic to be due
+    if (!batch_started)
+    {
+        batch_start_ms = I_GetLiveTimeMS();
+        batch_started = true;
+    }
+}
+
+// Once a second, size the tic batch so that running a batch and
+// presenting it takes no longer than the batch lasts in game time:
+// n * 1000 / TICRATE >= present + n * tic, for the average cost of a
+// presented frame and of one tic. A slow display then drops frames
+// rather than slowing the game.
+
+static void D_UpdateTicBatch(void)
+{
+    static framestats_t window;
+    int tics = framestats.tics - window.tics;
+    int frames = framestats.frames - window.frames;
+    int present_ms = framestats.present_ms - window.present_ms;
+    int spare, batch;
+
+    if (tics < TICRATE || frames == 0)
+        return;
+
+    // game time per window not spent running tics
+    spare = 1000 * tics - TICRATE * (framestats.sim_ms - window.sim_ms);
+    window = framestats;
+
+    if (spare <= 0)
+        batch = DG_MaxTicBatch;
+    else
+        batch = (TICRATE * present_ms * tics + frames * spare - 1)
+              / (frames * spare);
+
+    if (batch > (int) DG_MaxTicBatch)
+        batch = DG_MaxTicBatch;
+    if (batch < 1 || netgame || singletics)
+        batch = 1;
+
+    framestats.batch = batch;
+    ticbatch = batch;
+}
+
+static boolean D_PresentDue(int now)
+{
+    if (gametic - last_present_tic < framestats.batch)
+        return false;
+
+    // timedemos must draw every tic
+    if (DG_FrameIntervalMs == 0 || singletics)
+        return true;
+
+    return now + present_cost_ms - next_present_ms >= 0;
+}
+
+static void D_Present(int start)
+{
+    int interval = DG_FrameIntervalMs;
+    int now;
+
+    D_Display ();
+    now = I_GetLiveTimeMS();
+
+    // running average over about four frames
+    present_cost_ms = (present_cost_ms * 3 + (now - start)) / 4;
+    last_present_tic = gametic;
+
+    ++framestats.frames;
+    framestats.present_ms += now - start;
+    D_UpdateTicBatch();
+
+    // keep the cadence, unless a whole frame behind
+    next_present_ms += interval;
+    if (now - next_present_ms > interval)
+        next_present_ms = now;
+
+    PROFILE_FRAME();
+}
+
 void doomgeneric_Tick()
 {
+    int now;
+
     if (!wipe_active) {
         // frame syncronous IO operations
         I_StartFrame ();
@@ -419,14 +541,23 @@ void doomgeneric_Tick()
 
         S_UpdateSounds (players[consoleplayer].mo);// move positional sounds
 
+        now = I_GetLiveTimeMS();
+
+        if (batch_started)
+        {
+            framestats.sim_ms += now - batch_start_ms;
+            batch_started = false;
+        }
+
         // Update display, next frame, with current state.
-        if (screenvisible)
+        if (screenvisible && D_PresentDue(now))
         {
-            D_Display ();
+            D_Present (now);
         }
     }
     else {
         display_wipe();
+        PROFILE_FRAME();
     }
 }
 
@@ -435,6 +566,8 @@ void doomgeneric_Tick()
 //
 void D_DoomLoop (void)
 {
+    int p;
+
     if (bfgedition &&
         (demorecording || (gameaction == ga_playdemo) || netgame))
     {
@@ -467,6 +600,40 @@ void D_DoomLoop (void)
         wipegamestate = gamestate;
     }
 
+    //!
+    // @arg <n>
+    //
+    // Present at most n frames per second. The game still runs at
+    // 35 tics per second; 0 presents a frame for every new tic.
+    //
+
+    p = M_CheckParmWithArgs("-fps", 1);
+
+    if (p > 0)
+    {
+        int fps = atoi(myargv[p + 1]);
+
+        DG_FrameIntervalMs = fps > 0 ? 1000 / fps : 0;
+    }
+
+    //!
+    // @arg <n>
+    //
+    // When drawing cannot keep up, run up to n tics per presented
+    // frame so the game stays real time. 1 lets the game slow down.
+    //
+
+    p = M_CheckParmWithArgs("-ticbatch", 1);
+
+    if (p > 0)
+    {
+        int batch = atoi(myargv[p + 1]);
+
+        DG_MaxTicBatch = batch > 1 ? batch : 1;
+    }
+
+    PROFILE_INIT();
+
     doomgeneric_Tick();
 }
 
@@ -511,6 +678,22 @@ void D_AdvanceDemo (void)
 }
 
 
+//
+// D_PlayLoopDemo
+// Plays a demo of the demo sequence.  An IWAD stripped of its demos
+// by wadmin.py has none, so move on to the next page instead.
+//
+static void D_PlayLoopDemo (char *name)
+{
+    if (W_CheckNumForName(name) < 0)
+    {
+        advancedemo = true;
+        return;
+    }
+
+    G_DeferedPlayDemo(name);
+}
+
 //
 // This cycles through the demo sequences.
 // FIXME - version dependend demo numbers?
@@ -552,7 +735,7 @@ void D_DoAdvanceDemo (void)
 	  S_StartMusic (mus_intro);
 	break;
       case 1:
-	G_DeferedPlayDemo(DEH_String("demo1"));
+	D_PlayLoopDemo(DEH_String("demo1"));
 	break;
       case 2:
 	pagetic = 200;
@@ -560,7 +743,7 @@ void D_DoAdvanceDemo (void)
 	pagename = DEH_String("CREDIT");
 	break;
       case 3:
-	G_DeferedPlayDemo(DEH_String("demo2"));
+	D_PlayLoopDemo(DEH_String("demo2"));
 	break;
       case 4:
 	gamestate = GS_DEMOSCREEN;
@@ -581,11 +764,11 @@ void D_DoAdvanceDemo (void)
 	}
 	break;
       case 5:
-	G_DeferedPlayDemo(DEH_String("demo3"));
+	D_PlayLoopDemo(DEH_String("demo3"));
 	break;
         // THE DEFINITIVE DOOM Special Edition demo
       case 6:
-	G_DeferedPlayDemo(DEH_String("demo4"));
+	D_PlayLoopDemo(DEH_String("demo4"));
 	break;
     }
 
@@ -1082,10 +1265,12 @@ static void D_Endoom(void)
 
     // Don't show ENDOOM if we have it disabled, or we're running
     // in screensaver or control test mode. Only show it once the
-    // game has actually started.
+    // game has actually started, and if the IWAD has not had it
+    // stripped by wadmin.py.
 
     if (!show_endoom || !main_loop_started
-     || screensaver_mode || M_CheckParm("-testcontrols") > 0)
+     || screensaver_mode || M_CheckParm("-testcontrols") > 0
+     || W_CheckNumForName(DEH_String("ENDOOM")) < 0)
     {
         return;
     }
@@ -1176,7 +1361,9 @@ void D_DoomMain (void)
 {
     int p;
     char file[256];
-    char demolumpname[9];
+    // Static: D_DoomMain returns before the demo ends, and
+    // G_CheckDemoStatus releases the lump by this name.
+    static char demolumpname[9];
 #if ORIGCODE
     int numiwadlumps;
 #endif
@@ -1805,6 +1992,8 @@ void D_DoomMain (void)
         DEH_printf("External statistics registered.\n");
     }
 
+    P_StateHashInit();
+
     //!
     // @arg <x>
     // @category demo
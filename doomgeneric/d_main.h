@@ -45,6 +45,25 @@ void D_StartTitle (void);
 
 extern  gameaction_t    gameaction;
 
+// Frame pacing statistics, accumulated since startup. tics / frames
+// is the number of game tics run per presented frame.
+
+typedef struct
+{
+    int tics;               // game tics run
+    int sim_ms;             // time spent running them
+    int frames;             // frames drawn and presented
+    int present_ms;         // time spent in D_Display, incl. DG_DrawFrame
+    int batch;              // tics currently batched per presented frame
+} framestats_t;
+
+extern  framestats_t    framestats;
+
+// Called by RunTic before each tic; the first tic of a batch starts
+// the clock that times the batch.
+
+void D_StartTic (void);
+
 
 #endif
 
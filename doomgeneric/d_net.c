@@ -73,6 +73,8 @@ static void RunTic(ticcmd_t *cmds, boolean *ingame)
     extern boolean advancedemo;
     unsigned int i;
 
+    D_StartTic();
+
     // Check for player quits.
 
     for (i = 0; i < MAXPLAYERS; ++i)
@@ -92,6 +94,8 @@ static void RunTic(ticcmd_t *cmds, boolean *ingame)
         D_DoAdvanceDemo ();
 
     G_Ticker ();
+
+    ++framestats.tics;
 }
 
 static loop_interface_t doom_loop_interface = {
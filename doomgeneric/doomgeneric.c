@@ -1,16 +1,47 @@
 #include <stdio.h>
+#include <string.h>
 
 #include "m_argv.h"
 
 #include "doomgeneric.h"
 
 #include "i_video.h"
+#include "w_file.h"
 
 pixel_t *DG_ScreenBuffer = NULL;
+uint32_t DG_FrameIntervalMs = 0;
+uint32_t DG_MaxTicBatch = 1;
+uint32_t (*DG_GetLiveTicksMs)(void) = NULL;
 
 void M_FindResponseFile(void);
 void D_DoomMain(void);
 
+#ifdef EMBED_IWAD
+
+// The IWAD linked into the program by wad2c.py, opened in place
+// unless -iwad names another.
+extern const byte embedded_iwad[];
+extern const unsigned int embedded_iwad_length;
+
+static void AddEmbeddedIWAD(void)
+{
+	char **args;
+
+	W_AddMemoryFile(EMBED_IWAD, embedded_iwad, embedded_iwad_length);
+
+	if (M_CheckParm("-iwad") > 0)
+		return;
+
+	args = malloc((myargc + 3) * sizeof(*args));
+	memcpy(args, myargv, myargc * sizeof(*args));
+	args[myargc++] = "-iwad";
+	args[myargc++] = EMBED_IWAD;
+	args[myargc] = NULL;
+	myargv = args;
+}
+
+#endif
+
 void doomgeneric_Create(int argc, char **argv)
 {
 	// save arguments
@@ -19,7 +50,13 @@ void doomgeneric_Create(int argc, char **argv)
 
 	M_FindResponseFile();
 
-	DG_ScreenBuffer = malloc(SCREENWIDTH * SCREENHEIGHT * 4);
+#ifdef EMBED_IWAD
+	AddEmbeddedIWAD();
+#endif
+
+#ifndef CMAP_GLYPH
+	DG_ScreenBuffer = malloc(DOOMGENERIC_RESX * DOOMGENERIC_RESY * 4);
+#endif
 
 	DG_Init();
 
@@ -28,6 +28,24 @@ typedef uint32_t pixel_t;
 
 extern pixel_t *DG_ScreenBuffer;
 
+// Minimum milliseconds between presented frames, 0 for no limit.
+// Backends may set it in DG_Init; -fps overrides it.
+extern uint32_t DG_FrameIntervalMs;
+
+// Most game tics run per presented frame when drawing cannot keep up
+// at 35 Hz, so game time stays real time. 1 lets the game slow down
+// instead, as vanilla does. Backends may set it in DG_Init;
+// -ticbatch overrides it.
+extern uint32_t DG_MaxTicBatch;
+
+// Clock for measuring what tics and frames cost, in the time base of
+// DG_GetTicksMs. A backend whose DG_GetTicksMs only moves between
+// calls into it sets this in DG_Init; NULL uses DG_GetTicksMs.
+extern uint32_t (*DG_GetLiveTicksMs)(void);
+
+// CMAP_GLYPH: text backends encode I_VideoBuffer through i_ascii.h
+// and DG_ScreenBuffer is not allocated.
+
 void doomgeneric_Create(int argc, char **argv);
 void doomgeneric_Tick();
 
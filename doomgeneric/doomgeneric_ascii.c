@@ -16,8 +16,11 @@
 //
 
 #include "doomgeneric.h"
+#include "d_main.h"
 #include "doomkeys.h"
+#include "i_ascii.h"
 #include "i_system.h"
+#include "i_video.h"
 
 #include <ctype.h>
 #include <errno.h>
@@ -31,8 +34,14 @@
 #define OS_WINDOWS
 #define WIN32_LEAN_AND_MEAN
 // #define USE_COLOR
+// #define USE_COLOR_256	// nearest xterm-256 colour
+// #define USE_COLOR_16	// nearest of the 16 ANSI colours
+// #define HALF_BLOCKS	// 1x2 pixels per character
+// #define BRAILLE		// 2x4 pixels per character
 #include <windows.h>
 #else
+#define KITTY_KEYS // ask for key release events (kitty keyboard protocol)
+#include <pthread.h>
 #include <sys/ioctl.h>
 #include <termios.h>
 #include <time.h>
@@ -98,38 +107,242 @@ int clock_gettime(const int p, struct timespec *const spec)
 	} while (0)
 #define CALL_STDOUT(stmt, format) CALL((stmt) == EOF, format)
 
-#define BYTE_TO_TEXT(buf, byte)                      \
-	do {                                         \
-		*(buf)++ = '0' + (byte) / 100u;      \
-		*(buf)++ = '0' + (byte) / 10u % 10u; \
-		*(buf)++ = '0' + (byte) % 10u;       \
-	} while (0)
+/* Synchronized output: the terminal holds the old frame on screen
+ * until the whole update has arrived */
+#define SYNC_BEGIN "\033[?2026h\033[1m"
+#define SYNC_END "\033[?2026l"
+/* Room for SYNC_BEGIN, SYNC_END and the status line */
+#define FRAME_EXTRA 320u
 
-// #define GRAD_LEN 70u // RB replaced with static field
-#define INPUT_BUFFER_LEN 16u
-#define EVENT_BUFFER_LEN ((INPUT_BUFFER_LEN)*2u - 1u)
+#define INPUT_BUFFER_LEN 64u
 
-static const char grad[] = "  __--<<\\/\\/~~##░░▒▒▓▓████████"; // static const char grad[] =  " .'`^\",:;Il!i><~+_-?][}{1)(|\\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$";
-static size_t grad_len;  // Excludes the null terminator, set in init
-int frame_count = 0;
+/* Key events, pressed << 8 | doom key, from the input reader to
+ * DG_GetKey. Single producer, single consumer; power of two. */
+#define KEY_RING_LEN 256u
 
-struct color_t {
-	uint32_t b : 8;
-	uint32_t g : 8;
-	uint32_t r : 8;
-	uint32_t a : 8;
-};
+/* Without release events a held key is only seen again when the
+ * terminal repeats it, so it counts as released once it has not been
+ * seen for this long */
+#define KEY_RELEASE_MS 100u
+
+#ifdef OS_WINDOWS
+/* console input is read on the game thread */
+#define LOAD_ACQUIRE(p) (*(p))
+#define STORE_RELEASE(p, v) (*(p) = (v))
+#else
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+// Brightness ramp for the shared encoder (i_ascii.c)
+static const char glyph_ramp[] = "  __--<<\\/\\/~~##░░▒▒▓▓████████"; // " .'`^\",:;Il!i><~+_-?][}{1)(|\\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$";
+int frame_count = 0;
 
-static char *output_buffer;
 static size_t output_buffer_size;
 static struct timespec ts_init;
 
-static unsigned char input_buffer[INPUT_BUFFER_LEN];
-static uint16_t event_buffer[EVENT_BUFFER_LEN];
-static uint16_t *event_buf_loc;
+/* Output sink: DG_DrawFrame encodes into a buffer the writer thread
+ * does not own and publishes it as pending; the writer takes the
+ * pending frame and writes it in one go. A frame the writer has not
+ * taken by the time the next is ready is reclaimed and dropped, so
+ * the newest frame wins and the game never waits on the terminal.
+ * The writer owns at most one buffer, hence two are enough. */
+#define SINK_BUFFERS 2u
+
+typedef struct {
+	char *data;
+	size_t len;
+	int clears; /* starts by clearing the screen */
+} sink_frame_t;
+
+typedef struct {
+	uint32_t written;
+	uint32_t dropped;
+	uint64_t bytes;
+} sink_stats_t;
+
+static sink_frame_t sink_frames[SINK_BUFFERS];
+static sink_frame_t *sink_pending; /* published, not yet taken */
+static sink_frame_t *sink_writing; /* owned by the writer */
+static int sink_failed; /* the writer hit an error and stopped */
+static sink_stats_t sink_stats;
+
+#ifdef OS_WINDOWS
+static SRWLOCK sink_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE sink_cond = CONDITION_VARIABLE_INIT;
+#define SINK_LOCK() AcquireSRWLockExclusive(&sink_lock)
+#define SINK_UNLOCK() ReleaseSRWLockExclusive(&sink_lock)
+#define SINK_WAIT() SleepConditionVariableSRW(&sink_cond, &sink_lock, INFINITE, 0)
+#define SINK_WAKE() WakeAllConditionVariable(&sink_cond)
+#else
+static pthread_mutex_t sink_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sink_cond = PTHREAD_COND_INITIALIZER;
+#define SINK_LOCK() pthread_mutex_lock(&sink_lock)
+#define SINK_UNLOCK() pthread_mutex_unlock(&sink_lock)
+#define SINK_WAIT() pthread_cond_wait(&sink_cond, &sink_lock)
+#define SINK_WAKE() pthread_cond_broadcast(&sink_cond)
+#endif
+
+/* Write all of buf to stdout, bypassing stdio. Returns 0 on error. */
+static int SinkWrite(const char *buf, size_t len)
+{
+#ifdef OS_WINDOWS
+	const HANDLE hOutputHandle = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD written;
+	while (len > 0) {
+		if (!WriteFile(hOutputHandle, buf, (DWORD)len, &written, NULL))
+			return 0;
+		buf += written;
+		len -= written;
+	}
+#else
+	ssize_t written;
+	while (len > 0) {
+		written = write(STDOUT_FILENO, buf, len);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return 0;
+		buf += written;
+		len -= (size_t)written;
+	}
+#endif
+	return 1;
+}
+
+#ifdef OS_WINDOWS
+static DWORD WINAPI SinkThread(LPVOID arg)
+#else
+static void *SinkThread(void *arg)
+#endif
+{
+	sink_frame_t *frame;
+	int ok;
+
+	(void)arg;
+
+	for (;;) {
+		SINK_LOCK();
+		while (!sink_pending)
+			SINK_WAIT();
+		frame = sink_writing = sink_pending;
+		sink_pending = NULL;
+		SINK_UNLOCK();
+
+		ok = SinkWrite(frame->data, frame->len);
+
+		SINK_LOCK();
+		sink_writing = NULL;
+		if (ok) {
+			sink_stats.written++;
+			sink_stats.bytes += frame->len;
+		} else {
+			sink_failed = 1;
+		}
+		SINK_WAKE();
+		SINK_UNLOCK();
+
+		if (!ok)
+			return 0;
+	}
+}
+
+static void SinkStart(void)
+{
+	size_t i;
+
+	for (i = 0; i < SINK_BUFFERS; i++) {
+		sink_frames[i].data = malloc(output_buffer_size);
+		CALL(!sink_frames[i].data, "DG_Init: malloc error %d");
+	}
+
+	/* anything stdio holds goes out before the first frame */
+	CALL_STDOUT(fflush(stdout), "DG_Init: fflush error %d");
+
+#ifdef OS_WINDOWS
+	const HANDLE hThread = CreateThread(NULL, 0, SinkThread, NULL, 0, NULL);
+	WINDOWS_CALL(!hThread, "DG_Init: %s");
+	CloseHandle(hThread);
+#else
+	pthread_t sink_thread;
+	errno = pthread_create(&sink_thread, NULL, SinkThread, NULL);
+	CALL(errno != 0, "DG_Init: pthread_create error %d");
+	pthread_detach(sink_thread);
+#endif
+}
+
+/* Buffer for the next frame. Sets *dropped if that is the pending
+ * frame, reclaimed before the writer took it. */
+static sink_frame_t *SinkAcquire(int *const dropped)
+{
+	sink_frame_t *frame;
+
+	SINK_LOCK();
+	frame = sink_pending;
+	if (frame) {
+		sink_pending = NULL;
+		sink_stats.dropped++;
+		*dropped = 1;
+	} else {
+		frame = sink_writing == &sink_frames[0] ? &sink_frames[1] : &sink_frames[0];
+		*dropped = 0;
+	}
+	SINK_UNLOCK();
+
+	return frame;
+}
+
+static void SinkPublish(sink_frame_t *const frame)
+{
+	SINK_LOCK();
+	sink_pending = frame;
+	SINK_WAKE();
+	SINK_UNLOCK();
+}
+
+/* Wait for the writer to finish what it has, so nothing else is
+ * written to the terminal in the middle of a frame */
+static void SinkFlush(void)
+{
+	if (!sink_frames[0].data)
+		return;
+
+	SINK_LOCK();
+	while (!sink_failed && (sink_pending || sink_writing))
+		SINK_WAIT();
+	SINK_UNLOCK();
+}
+
+static sink_stats_t SinkStats(void)
+{
+	sink_stats_t stats;
+
+	SINK_LOCK();
+	stats = sink_stats;
+	SINK_UNLOCK();
+
+	return stats;
+}
+
+static uint16_t key_ring[KEY_RING_LEN];
+static unsigned key_head; /* written by the reader only */
+static unsigned key_tail; /* written by DG_GetKey only */
+
+/* Set once the terminal has sent a real key release */
+static int key_release_events;
+
+/* Game side key state, for synthesised releases */
+static unsigned char key_down[256];
+static uint32_t key_seen_ms[256];
+
+#ifndef OS_WINDOWS
+static struct termios orig_termios;
+#endif
 
 void DG_AtExit(void)
 {
+	SinkFlush();
+
 #ifdef OS_WINDOWS
 	DWORD mode;
 	const HANDLE hInputHandle = GetStdHandle(STD_INPUT_HANDLE);
@@ -140,18 +353,44 @@ void DG_AtExit(void)
 	mode |= ENABLE_ECHO_INPUT;
 	SetConsoleMode(hInputHandle, mode);
 #else
-	struct termios t;
-	if (UNLIKELY(tcgetattr(STDIN_FILENO, &t)))
-		return;
-	t.c_lflag |= ECHO;
-	tcsetattr(STDIN_FILENO, TCSANOW, &t);
+#ifdef KITTY_KEYS
+	fputs("\033[<u", stdout);
+	fflush(stdout);
+#endif
+	tcsetattr(STDIN_FILENO, TCSANOW, &orig_termios);
 #endif
 }
 
-void DG_Init()
+static void KeyRingPush(const uint16_t event)
 {
-	grad_len = strlen(grad); // RB for pixel-ascii list sizing
+	const unsigned head = key_head;
+
+	/* full: the game is not reading, drop the key */
+	if (head - LOAD_ACQUIRE(&key_tail) == KEY_RING_LEN)
+		return;
+
+	key_ring[head % KEY_RING_LEN] = event;
+	STORE_RELEASE(&key_head, head + 1u);
+}
+
+static int KeyRingPop(uint16_t *const event)
+{
+	const unsigned tail = key_tail;
+
+	if (tail == LOAD_ACQUIRE(&key_head))
+		return 0;
+
+	*event = key_ring[tail % KEY_RING_LEN];
+	STORE_RELEASE(&key_tail, tail + 1u);
+	return 1;
+}
+
+#ifndef OS_WINDOWS
+static void *InputThread(void *arg);
+#endif
 
+void DG_Init()
+{
 #ifdef OS_WINDOWS
 	const HANDLE hOutputHandle = GetStdHandle(STD_OUTPUT_HANDLE);
 	WINDOWS_CALL(hOutputHandle == INVALID_HANDLE_VALUE, "DG_Init: %s");
@@ -166,44 +405,72 @@ void DG_Init()
 	mode &= ~(ENABLE_MOUSE_INPUT | ENABLE_WINDOW_INPUT | ENABLE_QUICK_EDIT_MODE | ENABLE_ECHO_INPUT);
 	WINDOWS_CALL(!SetConsoleMode(hInputHandle, mode), "DG_Init: %s");
 #else
+	/* Raw mode once: no echo, no line buffering; reads block until a
+	 * key arrives, on the input thread */
 	struct termios t;
-	CALL(tcgetattr(STDIN_FILENO, &t), "DG_Init: tcgetattr error %d");
-	t.c_lflag &= ~(ECHO);
+	CALL(tcgetattr(STDIN_FILENO, &orig_termios), "DG_Init: tcgetattr error %d");
+	t = orig_termios;
+	t.c_lflag &= ~(ECHO | ICANON);
+	t.c_cc[VMIN] = 1;
+	t.c_cc[VTIME] = 0;
 	CALL(tcsetattr(STDIN_FILENO, TCSANOW, &t), "DG_Init: tcsetattr error %d");
 #endif
 	CALL(atexit(&DG_AtExit), "DG_Init: atexit error %d");
+#ifndef OS_WINDOWS
+#ifdef KITTY_KEYS
+	/* disambiguate, report event types, report all keys as escapes;
+	 * terminals without the protocol ignore this */
+	CALL_STDOUT(fputs("\033[>11u", stdout), "DG_Init: fputs error %d");
+#endif
+	pthread_t input_thread;
+	errno = pthread_create(&input_thread, NULL, InputThread, NULL);
+	CALL(errno != 0, "DG_Init: pthread_create error %d");
+	pthread_detach(input_thread);
+#endif
 
-	/* Longest SGR code: \033[38;2;RRR;GGG;BBBm (length 19)
-	 * Maximum 21 bytes per pixel: SGR + 2 x char
-	 * 1 Newline character per line
-	 * SGR clear code: \033[0m (length 4)
-	 */
-#ifdef USE_COLOR 
-	// 21u represents the maximum number of bytes needed per pixel for the ASCII color escape sequence
-	// +4u is for the start/end color-escape sequences + newline 
-	output_buffer_size = 21u * DOOMGENERIC_RESX * DOOMGENERIC_RESY + DOOMGENERIC_RESY + 4u;
+	/* Remote terminals can be slow; run up to half a second of tics
+	 * per frame rather than slow the game down */
+	DG_MaxTicBatch = 17;
+
+	/* Terminal cells are about twice as tall as they are wide,
+	 * so every pixel is written as 2 glyphs */
+	ascii_config_t config;
+#if defined(BRAILLE)
+	config.cell = ASCII_CELL_BRAILLE;
+#elif defined(HALF_BLOCKS)
+	config.cell = ASCII_CELL_HALFBLOCK;
 #else
-	 // RB: orig is 4 bytes per "pixel" for regular no-color ascii
-	output_buffer_size = 4u * DOOMGENERIC_RESX * DOOMGENERIC_RESY + DOOMGENERIC_RESY + 1;  // only need +1 for \n termination, no color terms
+	config.cell = ASCII_CELL_RAMP;
 #endif
-	output_buffer = malloc(output_buffer_size);
+	config.ramp = glyph_ramp;
+#if defined(USE_COLOR)
+	config.color = ASCII_TRUECOLOR;
+#elif defined(USE_COLOR_256)
+	config.color = ASCII_256COLOR;
+#elif defined(USE_COLOR_16)
+	config.color = ASCII_16COLOR;
+#else
+	config.color = ASCII_MONO;
+#endif
+	config.aspect = 2;
+	I_ASCIIConfigure(&config);
 
-	clock_gettime(CLK, &ts_init);
+	output_buffer_size = I_ASCIIDiffSize() + FRAME_EXTRA;
+	SinkStart();
 
-	memset(input_buffer, '\0', INPUT_BUFFER_LEN);
+	clock_gettime(CLK, &ts_init);
 }
 
 static uint32_t sum_frame_time = 0;
+static uint32_t sum_frame_bytes = 0;
 static uint32_t last_time = 0;
 const int fps_log_interval = 60; // frames
 
 void DG_DrawFrame()
-{    
-// Clear screen every frame in Windows
-#ifdef OS_WINDOWS
-	printf("Clear\n");
-	system("cls");  // Add this
-#endif
+{
+	static int clear_screen = 1;
+	sink_frame_t *frame;
+	int dropped;
 
 	uint32_t current_time = DG_GetTicksMs();
 	uint32_t frame_time = current_time - last_time;
@@ -212,81 +479,53 @@ void DG_DrawFrame()
 	sum_frame_time += frame_time;
 	frame_count++;
 
-	if (frame_count % fps_log_interval == 0) {
-		uint32_t avg_frame_time = sum_frame_time / fps_log_interval;
-		uint32_t fps = avg_frame_time > 0 ? 1000 / avg_frame_time : 0;
-		printf("Frame-time: %d ms\n", avg_frame_time);
-		printf("Framerate: %d FPS\n", fps);
-		sum_frame_time = 0; // Reset accumulator
+	/* A frame still pending never reached the terminal; this one
+	 * redraws what it would have */
+	frame = SinkAcquire(&dropped);
+	if (dropped) {
+		I_ASCIIDropDiff();
+		clear_screen |= frame->clears;
 	}
 
-	/* Clear screen if first frame */
-	static int first_frame = 0;
-	if (first_frame == 1) {
-		first_frame = 0;
-		CALL_STDOUT(fputs("\033[1;1H\033[2J", stdout), "DG_DrawFrame: fputs error %d");
-	}
+	char *buf = frame->data;
 
-	/* fill output buffer */
-#ifdef USE_COLOR
-	uint32_t color = 0xFFFFFF00;
-#endif
-	unsigned row, col;
-	struct color_t *pixel = (struct color_t *)DG_ScreenBuffer;
-	char *buf = output_buffer;
+	memcpy(buf, SYNC_BEGIN, sizeof(SYNC_BEGIN) - 1);
+	buf += sizeof(SYNC_BEGIN) - 1;
 
-	// RB added comments
-	// Iterate through each row and column of the output resolution
-	for (row = 0; row < DOOMGENERIC_RESY; row++) 
-	{
-		for (col = 0; col < DOOMGENERIC_RESX; col++) 
-		{
-#ifdef USE_COLOR
-			// Check if color changed from previous pixel (comparing RGB, ignoring alpha)
-			if ((color ^ *(uint32_t*)pixel) & 0x00FFFFFF) {
-				// ANSI escape sequence for 24-bit RGB color:
-				// \033[38;2;R;G;B;m
-				*buf++ = '\033';  // Escape character
-				*buf++ = '[';     // Start ANSI sequence
-				*buf++ = '3';     // Foreground color
-				*buf++ = '8';     // 24-bit RGB mode
-				*buf++ = ';';
-				*buf++ = '2';     // RGB submode
-				*buf++ = ';';
-				BYTE_TO_TEXT(buf, pixel->r);  // Convert R value to ASCII
-				*buf++ = ';';
-				BYTE_TO_TEXT(buf, pixel->g);  // Convert G value to ASCII
-				*buf++ = ';';
-				BYTE_TO_TEXT(buf, pixel->b);  // Convert B value to ASCII
-				*buf++ = 'm';     // End sequence
-				color = *(uint32_t*)pixel;   // Store current color
-			}
-#endif
-			// Convert RGB to grayscale index into ASCII gradient array
-			char v_char = grad[(pixel->r + pixel->g + pixel->b) * grad_len / 765u];  // 765 = 255*3
-			*buf++ = v_char;	// Write the character
-			*buf++ = v_char;	// Write a SECOND character, cause such chars are 2x taller than their width
-			pixel++;
-		}
-		*buf++ = '\n';           // End of row
+	/* Clear screen once; after that only changed cells are redrawn */
+	frame->clears = clear_screen;
+	if (clear_screen) {
+		clear_screen = 0;
+		memcpy(buf, "\033[2J", 4);
+		buf += 4;
+		I_ASCIIInvalidate();
 	}
 
-	// Reset terminal colors to default
-#ifdef USE_COLOR
-	*buf++ = '\033';
-	*buf++ = '[';
-	*buf++ = '0';
-	*buf = 'm';
-#endif
+	/* fill output buffer with the cells that changed */
+	const size_t len = I_ASCIIEncodeDiff(buf, I_VideoBuffer);
+	buf += len;
+	sum_frame_bytes += len;
 
-	/* move cursor to top left corner and set bold text*/
-	CALL_STDOUT(fputs("\033[;H\033[1m", stdout), "DG_DrawFrame: fputs error %d");
+	/* status line below the frame */
+	if (frame_count % fps_log_interval == 0) {
+		uint32_t avg_frame_time = sum_frame_time / fps_log_interval;
+		uint32_t fps = avg_frame_time > 0 ? 1000 / avg_frame_time : 0;
+		const sink_stats_t stats = SinkStats();
+		buf += sprintf(buf, "\033[%d;1H\033[0mFrame-time: %u ms  Framerate: %u FPS  Tics/frame: %.2f  Output: %u bytes/frame  Written: %u  Dropped: %u  Total: %llu KiB\033[K",
+			       I_ASCIIRows() + 1, avg_frame_time, fps,
+			       framestats.frames > 0 ? (double)framestats.tics / framestats.frames : 0.0,
+			       sum_frame_bytes / fps_log_interval,
+			       stats.written, stats.dropped, (unsigned long long)(stats.bytes >> 10));
+		sum_frame_time = 0; // Reset accumulator
+		sum_frame_bytes = 0;
+	}
 
-	/* flush output buffer */
-	CALL_STDOUT(fputs(output_buffer, stdout), "DG_DrawFrame: fputs error %d");
+	memcpy(buf, SYNC_END, sizeof(SYNC_END) - 1);
+	buf += sizeof(SYNC_END) - 1;
 
-	/* clear output buffer */
-	memset(output_buffer, '\0', buf - output_buffer + 1u);
+	/* the writer thread puts the whole update out in one write */
+	frame->len = buf - frame->data;
+	SinkPublish(frame);
 }
 
 void DG_SleepMs(const uint32_t ms)
@@ -403,17 +642,11 @@ static inline unsigned char convertToDoomKey(const WORD wVirtualKeyCode, const C
 	}
 }
 #else
-static unsigned char doomKeyIfTilda(const char **const buf, const unsigned char key)
+/* Doom key for the number and final byte of a CSI sequence, in the
+ * legacy xterm forms and the kitty keyboard protocol's */
+static unsigned char csiToDoomKey(const unsigned code, const char final)
 {
-	if (*((*buf) + 1) != '~')
-		return '\0';
-	(*buf)++;
-	return key;
-}
-
-static inline unsigned char convertCsiToDoomKey(const char **const buf)
-{
-	switch (**buf) {
+	switch (final) {
 	case 'A':
 		return KEY_UPARROW;
 	case 'B':
@@ -426,54 +659,117 @@ static inline unsigned char convertCsiToDoomKey(const char **const buf)
 		return KEY_HOME;
 	case 'F':
 		return KEY_END;
-	case '1':
-		switch (*((*buf) + 1)) {
-		case '5':
-			(*buf)++;
-			return doomKeyIfTilda(buf, KEY_F5);
-		case '7':
-			(*buf)++;
-			return doomKeyIfTilda(buf, KEY_F6);
-		case '8':
-			(*buf)++;
-			return doomKeyIfTilda(buf, KEY_F7);
-		case '9':
-			(*buf)++;
-			return doomKeyIfTilda(buf, KEY_F8);
+	case 'P':
+		return KEY_F1;
+	case 'Q':
+		return KEY_F2;
+	case 'R':
+		return KEY_F3;
+	case 'S':
+		return KEY_F4;
+	case '~':
+		switch (code) {
+		case 1:
+		case 7:
+			return KEY_HOME;
+		case 2:
+			return KEY_INS;
+		case 3:
+			return KEY_DEL;
+		case 4:
+		case 8:
+			return KEY_END;
+		case 5:
+			return KEY_PGUP;
+		case 6:
+			return KEY_PGDN;
+		case 11:
+			return KEY_F1;
+		case 12:
+			return KEY_F2;
+		case 13:
+			return KEY_F3;
+		case 14:
+			return KEY_F4;
+		case 15:
+			return KEY_F5;
+		case 17:
+			return KEY_F6;
+		case 18:
+			return KEY_F7;
+		case 19:
+			return KEY_F8;
+		case 20:
+			return KEY_F9;
+		case 21:
+			return KEY_F10;
+		case 23:
+			return KEY_F11;
+		case 24:
+			return KEY_F12;
 		default:
 			return '\0';
 		}
-	case '2':
-		switch (*((*buf) + 1)) {
-		case '0':
-			(*buf)++;
-			return doomKeyIfTilda(buf, KEY_F9);
-		case '1':
-			(*buf)++;
-			return doomKeyIfTilda(buf, KEY_F10);
-		case '3':
-			(*buf)++;
-			return doomKeyIfTilda(buf, KEY_F11);
-		case '4':
-			(*buf)++;
-			return doomKeyIfTilda(buf, KEY_F12);
-		case '~':
-			(*buf)++;
-			return KEY_INS;
+	case 'u':
+		switch (code) {
+		case 9:
+			return KEY_TAB;
+		case 13:
+			return KEY_ENTER;
+		case 27:
+			return KEY_ESCAPE;
+		case 127:
+			return KEY_BACKSPACE;
+		case 57441: /* left and right shift */
+		case 57447:
+			return KEY_RSHIFT;
+		case 57442: /* left and right control */
+		case 57448:
+			return KEY_RCTRL;
+		case 57443: /* left and right alt */
+		case 57449:
+			return KEY_RALT;
 		default:
-			return '\0';
+			return code < 128u ? tolower(code) : '\0';
 		}
-	case '3':
-		return doomKeyIfTilda(buf, KEY_DEL);
-	case '5':
-		return doomKeyIfTilda(buf, KEY_PGUP);
-	case '6':
-		return doomKeyIfTilda(buf, KEY_PGDN);
 	default:
 		return '\0';
 	}
 }
 
+/* CSI [code][;modifiers[:event]] final, with *buf just past the CSI.
+ * Event 1 is a press, 2 a repeat and 3 a release; only terminals
+ * speaking the kitty protocol send events or the 'u' form. A
+ * sequence cut off by the end of the input leaves *buf on the NUL. */
+static inline unsigned char convertCsiToDoomKey(const char **const buf, int *const pressed)
+{
+	const char *p = *buf;
+	unsigned code = 0, event = 1;
+
+	while (isdigit((unsigned char)*p))
+		code = code * 10u + (unsigned)(*p++ - '0');
+
+	if (*p == ';') {
+		for (p++; isdigit((unsigned char)*p); p++)
+			; /* modifiers are not used */
+		if (*p == ':') {
+			event = 0;
+			for (p++; isdigit((unsigned char)*p); p++)
+				event = event * 10u + (unsigned)(*p - '0');
+		}
+	}
+
+	*buf = p;
+	if (*p == '\0')
+		return '\0';
+
+	if (*p == 'u' || event != 1)
+		STORE_RELEASE(&key_release_events, 1);
+
+	*pressed = event != 3;
+	return csiToDoomKey(code, *p);
+}
+
 static inline unsigned char convertSs3ToDoomKey(const char **const buf)
 {
 	switch (**buf) {
@@ -490,8 +786,12 @@ static inline unsigned char convertSs3ToDoomKey(const char **const buf)
 	}
 }
 
-static inline unsigned char convertToDoomKey(const char **const buf)
+/* Leaves *buf on the last byte of the key's sequence, or on the NUL
+ * ending the input if the sequence is not complete */
+static inline unsigned char convertToDoomKey(const char **const buf, int *const pressed)
 {
+	*pressed = 1;
+
 	switch (**buf) {
 	case '\012':
 		return KEY_ENTER;
@@ -499,7 +799,7 @@ static inline unsigned char convertToDoomKey(const char **const buf)
 		switch (*((*buf) + 1)) {
 		case '[':
 			*buf += 2;
-			return convertCsiToDoomKey(buf);
+			return convertCsiToDoomKey(buf, pressed);
 		case 'O':
 			*buf += 2;
 			return convertSs3ToDoomKey(buf);
@@ -510,124 +810,135 @@ static inline unsigned char convertToDoomKey(const char **const buf)
 		return tolower(**buf);
 	}
 }
-#endif
 
-void DG_ReadInput(void)
+/* Blocks on stdin and feeds the key ring, so keys that arrive between
+ * frames are neither lost nor wait for the game loop to read them */
+static void *InputThread(void *arg)
 {
-	static unsigned char prev_input_buffer[INPUT_BUFFER_LEN];
+	char raw_input_buffer[INPUT_BUFFER_LEN + 1u];
+	const char *raw_input_buf_loc;
+	const char *seq_start;
+	unsigned char key;
+	size_t kept = 0;
+	ssize_t len;
+	int pressed;
+
+	(void)arg;
+
+	for (;;) {
+		/* a sequence as long as the buffer is not a key */
+		if (kept == INPUT_BUFFER_LEN)
+			kept = 0;
+
+		len = read(STDIN_FILENO, raw_input_buffer + kept, INPUT_BUFFER_LEN - kept);
+		if (len < 0 && errno == EINTR)
+			continue;
+		if (len <= 0)
+			return NULL;
+		len += kept;
+		raw_input_buffer[len] = '\0';
+		kept = 0;
+
+		for (raw_input_buf_loc = raw_input_buffer; *raw_input_buf_loc; raw_input_buf_loc++) {
+			seq_start = raw_input_buf_loc;
+			key = convertToDoomKey(&raw_input_buf_loc, &pressed);
+
+			/* the read ended inside an escape sequence: keep its
+			 * start for the next read to complete */
+			if (*raw_input_buf_loc == '\0') {
+				kept = raw_input_buffer + len - seq_start;
+				memmove(raw_input_buffer, seq_start, kept);
+				break;
+			}
+
+			if (key)
+				KeyRingPush((pressed ? 0x0100 : 0) | key);
+		}
+	}
+}
+#endif
 
-	memcpy(prev_input_buffer, input_buffer, INPUT_BUFFER_LEN);
-	memset(input_buffer, '\0', INPUT_BUFFER_LEN);
-	memset(event_buffer, '\0', 2u * (size_t)EVENT_BUFFER_LEN);
-	event_buf_loc = event_buffer;
 #ifdef OS_WINDOWS
+/* Move pending console key events into the ring. ReadConsoleInput
+ * blocks when there are none, so count them first. */
+static void ReadConsoleKeys(void)
+{
 	const HANDLE hInputHandle = GetStdHandle(STD_INPUT_HANDLE);
-	WINDOWS_CALL(hInputHandle == INVALID_HANDLE_VALUE, "DG_ReadInput: %s");
-
-	/* Disable canonical mode */
-	DWORD old_mode, new_mode;
-	WINDOWS_CALL(!GetConsoleMode(hInputHandle, &old_mode), "DG_ReadInput: %s");
-	new_mode = old_mode;
-	new_mode &= ~(ENABLE_ECHO_INPUT | ENABLE_LINE_INPUT);
-	WINDOWS_CALL(!SetConsoleMode(hInputHandle, new_mode), "DG_ReadInput: %s");
+	WINDOWS_CALL(hInputHandle == INVALID_HANDLE_VALUE, "DG_GetKey: %s");
 
 	DWORD event_cnt;
-	WINDOWS_CALL(!GetNumberOfConsoleInputEvents(hInputHandle, &event_cnt), "DG_ReadInput: %s");
-
-	/* ReadConsole is blocking so must manually process events */
-	unsigned input_count = 0;
-	if (event_cnt) {
-		INPUT_RECORD input_records[32];
-		WINDOWS_CALL(!ReadConsoleInput(hInputHandle, input_records, 32, &event_cnt), "DG_ReadInput: %s");
-
-		DWORD i;
-		for (i = 0; i < event_cnt; i++) {
-			if (input_records[i].Event.KeyEvent.bKeyDown && input_records[i].EventType == KEY_EVENT) {
-				unsigned char inp = convertToDoomKey(input_records[i].Event.KeyEvent.wVirtualKeyCode, input_records[i].Event.KeyEvent.uChar.AsciiChar);
-				if (inp) {
-					input_buffer[input_count++] = inp;
-					if (input_count == INPUT_BUFFER_LEN - 1u)
-						break;
-				}
-			}
+	WINDOWS_CALL(!GetNumberOfConsoleInputEvents(hInputHandle, &event_cnt), "DG_GetKey: %s");
+	if (!event_cnt)
+		return;
+
+	INPUT_RECORD input_records[32];
+	WINDOWS_CALL(!ReadConsoleInput(hInputHandle, input_records, 32, &event_cnt), "DG_GetKey: %s");
+
+	/* the console reports real key-ups */
+	key_release_events = 1;
+
+	DWORD i;
+	for (i = 0; i < event_cnt; i++) {
+		if (input_records[i].EventType == KEY_EVENT) {
+			unsigned char inp = convertToDoomKey(input_records[i].Event.KeyEvent.wVirtualKeyCode, input_records[i].Event.KeyEvent.uChar.AsciiChar);
+			if (inp)
+				KeyRingPush((input_records[i].Event.KeyEvent.bKeyDown ? 0x0100 : 0) | inp);
 		}
 	}
+}
+#endif
 
-	WINDOWS_CALL(!SetConsoleMode(hInputHandle, old_mode), "DG_ReadInput: %s");
-#else /* defined(OS_WINDOWS) */
-	static char raw_input_buffer[INPUT_BUFFER_LEN];
-	struct termios oldt, newt;
-
-	memset(raw_input_buffer, '\0', INPUT_BUFFER_LEN);
-
-	/* Disable canonical mode */
-	CALL(tcgetattr(STDIN_FILENO, &oldt), "DG_DrawFrame: tcgetattr error %d");
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON);
-	newt.c_cc[VMIN] = 0;
-	newt.c_cc[VTIME] = 0;
-	CALL(tcsetattr(STDIN_FILENO, TCSANOW, &newt), "DG_DrawFrame: tcsetattr error %d");
-
-	CALL(read(2, raw_input_buffer, INPUT_BUFFER_LEN - 1u) < 0, "DG_DrawFrame: read error %d");
-
-	CALL(tcsetattr(STDIN_FILENO, TCSANOW, &oldt), "DG_DrawFrame: tcsetattr error %d");
-
-	/* Flush input buffer to prevent read of previous unread input */
-	CALL(tcflush(STDIN_FILENO, TCIFLUSH), "DG_DrawFrame: tcflush error %d");
-
-	/* create input buffer */
-	const char *raw_input_buf_loc = raw_input_buffer;
-	unsigned char *input_buf_loc = input_buffer;
-	while (*raw_input_buf_loc) {
-		const unsigned char inp = convertToDoomKey(&raw_input_buf_loc);
-		if (!inp)
-			break;
-		*input_buf_loc++ = inp;
-		raw_input_buf_loc++;
-	}
+int DG_GetKey(int *const pressed, unsigned char *const doomKey)
+{
+#ifdef OS_WINDOWS
+	static int draining = 0;
 #endif
-	/* construct event array */
-	int i, j;
-	for (i = 0; input_buffer[i]; i++) {
-		/* skip duplicates */
-		for (j = i + 1; input_buffer[j]; j++) {
-			if (input_buffer[i] == input_buffer[j])
-				goto LBL_CONTINUE_1;
-		}
+	static int release_key = 0;
+	const uint32_t now = DG_GetTicksMs();
+	uint16_t event;
+	unsigned char key;
 
-		/* pressed events */
-		for (j = 0; prev_input_buffer[j]; j++) {
-			if (input_buffer[i] == prev_input_buffer[j])
-				goto LBL_CONTINUE_1;
+#ifdef OS_WINDOWS
+	if (!draining)
+		ReadConsoleKeys();
+	draining = 1;
+#endif
+
+	while (KeyRingPop(&event)) {
+		key = event & 0xFF;
+		if (event >> 8) {
+			key_seen_ms[key] = now;
+			if (key_down[key])
+				continue; /* repeat */
+			key_down[key] = 1;
+		} else {
+			if (!key_down[key])
+				continue;
+			key_down[key] = 0;
 		}
-		*event_buf_loc++ = 0x0100 | input_buffer[i];
 
-	LBL_CONTINUE_1:;
+		*pressed = event >> 8;
+		*doomKey = key;
+		return 1;
 	}
 
-	/* depressed events */
-	for (i = 0; prev_input_buffer[i]; i++) {
-		for (j = 0; input_buffer[j]; j++) {
-			if (prev_input_buffer[i] == input_buffer[j])
-				goto LBL_CONTINUE_2;
+	/* synthesised releases, resumed where the last call stopped */
+	if (!LOAD_ACQUIRE(&key_release_events)) {
+		for (; release_key < 256; release_key++) {
+			if (key_down[release_key] && now - key_seen_ms[release_key] > KEY_RELEASE_MS) {
+				key_down[release_key] = 0;
+				*pressed = 0;
+				*doomKey = release_key++;
+				return 1;
+			}
 		}
-		*event_buf_loc++ = 0xFF & prev_input_buffer[i];
-
-	LBL_CONTINUE_2:;
 	}
 
-	event_buf_loc = event_buffer;
-}
-
-int DG_GetKey(int *const pressed, unsigned char *const doomKey)
-{
-	if (event_buf_loc == NULL || *event_buf_loc == 0)
-		return 0;
-
-	*pressed = *event_buf_loc >> 8;
-	*doomKey = *event_buf_loc & 0xFF;
-	event_buf_loc++;
-	return 1;
+	release_key = 0;
+#ifdef OS_WINDOWS
+	draining = 0;
+#endif
+	return 0;
 }
 
 void DG_SetWindowTitle(const char *const title)
@@ -0,0 +1,474 @@
+//
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Backend without a display, for benchmarks and unattended runs.
+//     Build with "make -f Makefile.headless", then e.g.
+//
+//         ./doomgeneric_headless -iwad doom1.wad -timedemo demo1
+//
+//     -virtualclock      time only passes in DG_SleepMs, so runs
+//                        are as fast as the machine and repeatable
+//     -sink <type>       null (default), raw (I_VideoBuffer palette
+//                        indices) or ascii (the text encoder)
+//     -sinkfile <file>   where raw and ascii frames go, default stdout
+//     -framehash <file>  with -timedemo, hashes of every frame for
+//     -framecheck <file> validating renderer and encoder changes;
+//                        the ascii encoder runs for them whatever
+//                        the sink
+//     -keys <file>       scripted input, one event per line:
+//                        "<ms> down|up <key>" or "<ms> quit"; keys
+//                        are single characters or names (enter,
+//                        escape, up, fire, f1, ...)
+//
+//     At exit a report of frames and frame times goes to stderr.
+//     "make -f Makefile.headless RGBA=1" builds the RGBA frame buffer
+//     path of the other backends instead of the text one, without
+//     the ascii sink.
+//
+
+#include "doomgeneric.h"
+#include "d_main.h"
+#include "doomkeys.h"
+#include "doomstat.h"
+#include "i_ascii.h"
+#include "i_framehash.h"
+#include "i_system.h"
+#include "i_video.h"
+#include "m_argv.h"
+#include "p_statehash.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#define KEY_SCRIPT_QUIT 0
+
+typedef enum {
+	SINK_NULL,
+	SINK_RAW,
+	SINK_ASCII,
+} sink_t;
+
+typedef struct {
+	uint32_t ms;
+	int pressed;
+	unsigned char key; /* KEY_SCRIPT_QUIT to quit */
+} script_event_t;
+
+typedef struct {
+	const char *name;
+	unsigned char key;
+} key_name_t;
+
+static const key_name_t key_names[] = {
+	{ "enter", KEY_ENTER },
+	{ "escape", KEY_ESCAPE },
+	{ "tab", KEY_TAB },
+	{ "backspace", KEY_BACKSPACE },
+	{ "space", ' ' },
+	{ "up", KEY_UPARROW },
+	{ "down", KEY_DOWNARROW },
+	{ "left", KEY_LEFTARROW },
+	{ "right", KEY_RIGHTARROW },
+	{ "strafeleft", KEY_STRAFE_L },
+	{ "straferight", KEY_STRAFE_R },
+	{ "fire", KEY_FIRE },
+	{ "use", KEY_USE },
+	{ "shift", KEY_RSHIFT },
+	{ "ctrl", KEY_RCTRL },
+	{ "alt", KEY_RALT },
+	{ "pause", KEY_PAUSE },
+	{ "f1", KEY_F1 },
+	{ "f2", KEY_F2 },
+	{ "f3", KEY_F3 },
+	{ "f4", KEY_F4 },
+	{ "f5", KEY_F5 },
+	{ "f6", KEY_F6 },
+	{ "f7", KEY_F7 },
+	{ "f8", KEY_F8 },
+	{ "f9", KEY_F9 },
+	{ "f10", KEY_F10 },
+	{ "f11", KEY_F11 },
+	{ "f12", KEY_F12 },
+	{ NULL, 0 },
+};
+
+int frame_count = 0;
+
+static int virtual_clock;
+static uint32_t virtual_ms;
+static struct timespec ts_init;
+
+static sink_t sink = SINK_NULL;
+static FILE *sink_file;
+#ifdef CMAP_GLYPH
+static char *sink_buffer;
+#endif
+static uint64_t sink_bytes;
+
+static script_event_t *script;
+static size_t script_len;
+static size_t script_pos;
+
+/* real time, whatever the game clock does */
+static uint64_t wall_start_ns;
+static uint64_t first_frame_ns;
+static uint64_t last_frame_ns;
+static uint64_t min_interval_ns = UINT64_MAX;
+static uint64_t max_interval_ns;
+static uint64_t sink_ns;
+static uint64_t demo_start_ns; /* -timedemo playback, as G_DoPlayDemo */
+static uint64_t demo_end_ns;
+static int demo_failed;
+static int quit_clean;
+
+static uint64_t WallNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static unsigned char KeyFromName(const char *name)
+{
+	const key_name_t *k;
+
+	if (name[0] != '\0' && name[1] == '\0')
+		return tolower((unsigned char)name[0]);
+
+	for (k = key_names; k->name != NULL; k++) {
+		if (!strcasecmp(k->name, name))
+			return k->key;
+	}
+
+	return 0;
+}
+
+static void LoadScript(const char *filename)
+{
+	char line[256], action[16], name[32];
+	size_t size = 0;
+	unsigned ms;
+	int lineno = 0, fields;
+	FILE *f;
+
+	f = fopen(filename, "r");
+	if (f == NULL)
+		I_Error("DG_Init: cannot open key script %s", filename);
+
+	while (fgets(line, sizeof(line), f) != NULL) {
+		lineno++;
+		if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+			continue;
+
+		fields = sscanf(line, "%u %15s %31s", &ms, action, name);
+
+		if (script_len == size) {
+			size = size ? size * 2 : 64;
+			script = realloc(script, size * sizeof(*script));
+			if (script == NULL)
+				I_Error("DG_Init: out of memory for key script");
+		}
+
+		script[script_len].ms = ms;
+		if (fields == 2 && !strcasecmp(action, "quit")) {
+			script[script_len].pressed = 1;
+			script[script_len].key = KEY_SCRIPT_QUIT;
+		} else if (fields == 3 && (!strcasecmp(action, "down") || !strcasecmp(action, "up"))) {
+			script[script_len].pressed = !strcasecmp(action, "down");
+			script[script_len].key = KeyFromName(name);
+			if (script[script_len].key == 0)
+				I_Error("%s:%d: unknown key '%s'", filename, lineno, name);
+		} else {
+			I_Error("%s:%d: expected \"<ms> down|up <key>\" or \"<ms> quit\"", filename, lineno);
+		}
+
+		if (script_len > 0 && ms < script[script_len - 1].ms)
+			I_Error("%s:%d: events must be in time order", filename, lineno);
+
+		script_len++;
+	}
+
+	fclose(f);
+}
+
+static void HeadlessReport(void)
+{
+	const uint64_t wall_ns = WallNs() - wall_start_ns;
+	const double wall_s = wall_ns / 1e9;
+
+	if (sink_file != NULL)
+		fflush(sink_file);
+
+	fprintf(stderr, "headless: %d frames, %d tics in %.3f s: %.1f frames/s, %.1f tics/s\n",
+		frame_count, gametic, wall_s,
+		wall_s > 0 ? frame_count / wall_s : 0.0,
+		wall_s > 0 ? gametic / wall_s : 0.0);
+
+	if (frame_count > 1) {
+		fprintf(stderr, "headless: frame interval %.3f/%.3f/%.3f ms min/avg/max, sink %.3f ms/frame, %llu bytes\n",
+			min_interval_ns / 1e6,
+			(last_frame_ns - first_frame_ns) / 1e6 / (frame_count - 1),
+			max_interval_ns / 1e6,
+			sink_ns / 1e6 / frame_count,
+			(unsigned long long)sink_bytes);
+	}
+
+	if (demo_end_ns > demo_start_ns) {
+		const double demo_s = (demo_end_ns - demo_start_ns) / 1e9;
+		fprintf(stderr, "headless: timedemo %d tics in %.6f s: %.1f tics/s\n",
+			gametic, demo_s, gametic / demo_s);
+	}
+}
+
+/* Registered when playback starts, after G_CheckDemoStatus, so it
+ * runs before it: a -timedemo still under way here was cut short by
+ * an error, which G_CheckDemoStatus then reports as the end. */
+static void HeadlessDemoExit(void)
+{
+	if (timingdemo)
+		demo_failed = 1;
+}
+
+/* Registered after HeadlessExit, so it runs just before it; I_Error
+ * only runs the handlers registered to run on errors. */
+static void HeadlessQuit(void)
+{
+	quit_clean = 1;
+}
+
+/* I_Error and I_Quit do not exit in this tree, and -timedemo ends in
+ * I_Error, so exit here; the report runs from atexit, which also
+ * catches the exit(0) after ENDOOM. */
+static void HeadlessExit(void)
+{
+	const int completed = demo_start_ns != 0 && !timingdemo && !demo_failed;
+	int failed;
+
+	if (completed)
+		demo_end_ns = WallNs();
+
+	/* a -timedemo run ends in I_Error, so it must reach its end;
+	 * any other run fails on an error */
+	if (M_CheckParm("-timedemo") > 0)
+		failed = !completed;
+	else
+		failed = !quit_clean;
+
+	exit(failed || I_FrameHashFailed() || P_StateHashFailed());
+}
+
+void DG_Init()
+{
+	const char *name;
+	int p;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts_init);
+	wall_start_ns = WallNs();
+
+	/* first, so that errors below exit too */
+	atexit(HeadlessReport);
+	I_AtExit(HeadlessExit, true);
+	I_AtExit(HeadlessQuit, false);
+
+	//!
+	// @category obscure
+	//
+	// Headless backend: the game clock only advances when the
+	// engine sleeps, so runs are repeatable and as fast as possible.
+	//
+
+	virtual_clock = M_ParmExists("-virtualclock");
+
+	//!
+	// @arg <type>
+	// @category obscure
+	//
+	// Headless backend: send frames to the null, raw or ascii sink.
+	//
+
+	p = M_CheckParmWithArgs("-sink", 1);
+	if (p > 0) {
+		name = myargv[p + 1];
+		if (!strcasecmp(name, "null"))
+			sink = SINK_NULL;
+		else if (!strcasecmp(name, "raw"))
+			sink = SINK_RAW;
+		else if (!strcasecmp(name, "ascii"))
+			sink = SINK_ASCII;
+		else
+			I_Error("DG_Init: unknown sink '%s'", name);
+	}
+
+	//!
+	// @arg <file>
+	// @category obscure
+	//
+	// Headless backend: write raw or ascii frames to this file.
+	//
+
+	sink_file = stdout;
+	p = M_CheckParmWithArgs("-sinkfile", 1);
+	if (p > 0 && sink != SINK_NULL) {
+		sink_file = fopen(myargv[p + 1], "wb");
+		if (sink_file == NULL)
+			I_Error("DG_Init: cannot open %s: %s", myargv[p + 1], strerror(errno));
+	}
+
+	//!
+	// @arg <file>
+	// @category obscure
+	//
+	// Headless backend: play key events from a script.
+	//
+
+	p = M_CheckParmWithArgs("-keys", 1);
+	if (p > 0)
+		LoadScript(myargv[p + 1]);
+
+#ifdef CMAP_GLYPH
+	if (sink == SINK_ASCII || M_CheckParm("-framehash") > 0 || M_CheckParm("-framecheck") > 0) {
+		ascii_config_t config;
+
+		config.cell = ASCII_CELL_RAMP;
+		config.ramp = " .:-=+*#%@";
+		config.color = ASCII_MONO;
+		config.aspect = 2;
+		I_ASCIIConfigure(&config);
+
+		sink_buffer = malloc(I_ASCIIFrameSize());
+		if (sink_buffer == NULL)
+			I_Error("DG_Init: out of memory for the ascii sink");
+	}
+#else
+	if (sink == SINK_ASCII)
+		I_Error("DG_Init: the ascii sink needs a CMAP_GLYPH build");
+#endif
+
+}
+
+void DG_DrawFrame()
+{
+	const uint64_t now = WallNs();
+	size_t len;
+
+	if (frame_count == 0) {
+		first_frame_ns = now;
+	} else {
+		const uint64_t interval = now - last_frame_ns;
+		if (interval < min_interval_ns)
+			min_interval_ns = interval;
+		if (interval > max_interval_ns)
+			max_interval_ns = interval;
+	}
+	last_frame_ns = now;
+	frame_count++;
+
+	switch (sink) {
+	case SINK_NULL:
+		break;
+	case SINK_RAW:
+		len = DOOMGENERIC_RESX * DOOMGENERIC_RESY;
+		if (fwrite(I_VideoBuffer, 1, len, sink_file) != len)
+			I_Error("DG_DrawFrame: write error %d", errno);
+		sink_bytes += len;
+		break;
+	case SINK_ASCII:
+#ifdef CMAP_GLYPH
+		len = I_ASCIIEncodeFrame(sink_buffer, I_VideoBuffer);
+		I_FrameHashBytes(FRAMEHASH_ASCII, sink_buffer, len);
+		sink_buffer[len++] = '\n';
+		if (fwrite(sink_buffer, 1, len, sink_file) != len)
+			I_Error("DG_DrawFrame: write error %d", errno);
+		sink_bytes += len;
+#endif
+		break;
+	}
+
+#ifdef CMAP_GLYPH
+	if (sink != SINK_ASCII && I_FrameHashing()) {
+		len = I_ASCIIEncodeFrame(sink_buffer, I_VideoBuffer);
+		I_FrameHashBytes(FRAMEHASH_ASCII, sink_buffer, len);
+	}
+#endif
+
+	sink_ns += WallNs() - now;
+}
+
+void DG_SleepMs(const uint32_t ms)
+{
+	if (virtual_clock) {
+		virtual_ms += ms;
+		return;
+	}
+
+	const struct timespec ts = (struct timespec){
+		.tv_sec = ms / 1000,
+		.tv_nsec = (ms % 1000ul) * 1000000,
+	};
+	nanosleep(&ts, NULL);
+}
+
+uint32_t DG_GetTicksMs()
+{
+	/* starttime is read just before playback starts */
+	if (timingdemo && demoplayback && demo_start_ns == 0) {
+		demo_start_ns = WallNs();
+		I_AtExit(HeadlessDemoExit, true);
+	}
+
+	if (virtual_clock)
+		return virtual_ms;
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (ts.tv_sec - ts_init.tv_sec) * 1000 + (ts.tv_nsec - ts_init.tv_nsec) / 1000000;
+}
+
+int DG_GetKey(int *const pressed, unsigned char *const doomKey)
+{
+	if (script_pos == script_len || script[script_pos].ms > DG_GetTicksMs())
+		return 0;
+
+	if (script[script_pos].key == KEY_SCRIPT_QUIT)
+		I_Quit();
+
+	*pressed = script[script_pos].pressed;
+	*doomKey = script[script_pos].key;
+	script_pos++;
+
+	return 1;
+}
+
+void DG_SetWindowTitle(const char *const title)
+{
+	(void)title;
+}
+
+int main(int argc, char **argv)
+{
+	doomgeneric_Create(argc, argv);
+
+	for (;;)
+		doomgeneric_Tick();
+
+	return 0;
+}
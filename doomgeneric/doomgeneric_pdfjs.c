@@ -23,10 +23,13 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include "d_main.h"
+#include "i_ascii.h"
 #include "i_video.h"
 #include "doomgeneric.h"
 #include "doomkeys.h"
 #include "i_system.h"
+#include "w_file.h"
 
 
 #define WIN32
@@ -35,8 +38,13 @@
 // #define OS_WINDOWS ... #include <windows.h>
 #define WIN32_LEAN_AND_MEAN
 // #define FRAME_LIMITING
+// #define FPS_LOG	// frame time and tics per frame every 60 frames
 // #define DOUBLE_CHAR_ASPECT
 // #define USE_COLOR
+// #define USE_COLOR_256	// nearest xterm-256 colour
+// #define USE_COLOR_16	// nearest of the 16 ANSI colours
+// #define HALF_BLOCKS	// 1x2 pixels per character
+// #define BRAILLE		// 2x4 pixels per character
 
 #else
 #include <sys/ioctl.h>
@@ -46,9 +54,22 @@
 #endif
 
 // RB pdf-js
+// JS bridge (pre.js): key events and the clock are written by JS into
+// this block of the heap, so reading them needs no call into JS. Key
+// events are pressed << 8 | doomkey, appended at key_head by JS and
+// taken from key_tail by DG_GetKey.
+#define KEY_RING_LEN 64
+
+static struct
+{
+	uint32_t now;		// Date.now(), low 32 bits
+	uint32_t key_head;
+	uint32_t key_tail;
+	uint16_t keys[KEY_RING_LEN];
+} js_bridge;
+
 int frame_count = 0;
 uint32_t start_time;
-static uint32_t last_frame_time = 0;
 static const uint32_t TARGET_FRAME_TIME = 33; // ~30 FPS target
 
 #ifdef OS_WINDOWS
@@ -100,9 +121,9 @@ int clock_gettime(const int p, struct timespec* const spec)
 
 uint32_t get_time() // pdf-js implementation
 {
-	return EM_ASM_INT({
-	  return Date.now();
-		});
+	// Refreshed by pre.js whenever JS runs: before every tick, after
+	// every frame and in DG_SleepMs
+	return js_bridge.now;
 }
 
 uint32_t DG_GetTicksMs()
@@ -110,40 +131,58 @@ uint32_t DG_GetTicksMs()
 	// pdf-js implementation
 	return get_time() - start_time;
 }
+
+// DG_GetLiveTicksMs: js_bridge.now stands still within a doom_tick,
+// so what tics and frames cost is measured with a call into JS.
+static uint32_t get_live_ticks_ms(void)
+{
+	return (uint32_t)EM_ASM_INT({ return Date.now() | 0; }) - start_time;
+}
 #endif
 
 #ifdef __GNUC__
 #define UNLIKELY(x) __builtin_expect((x), 0)
 #endif
 
-#define BYTE_TO_TEXT(buf, byte)                      \
-	do {                                         \
-		*(buf)++ = '0' + (byte) / 100u;      \
-		*(buf)++ = '0' + (byte) / 10u % 10u; \
-		*(buf)++ = '0' + (byte) % 10u;       \
-	} while (0)
-
-#define GRAD_LEN 4u
 #define INPUT_BUFFER_LEN 16u
 #define EVENT_BUFFER_LEN ((INPUT_BUFFER_LEN)*2u - 1u)
 
-static const char grad[] = "  __--<<\\/\\/~~##░░▒▒▓▓████████"; // static const char grad[] =  " .'`^\",:;Il!i><~+_-?][}{1)(|\\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$";
-static size_t grad_len;  // Excludes the null terminator, set in init
-
-struct color_t {
-	uint32_t b : 8;
-	uint32_t g : 8;
-	uint32_t r : 8;
-	uint32_t a : 8;
-};
+// Brightness ramp for the shared encoder (i_ascii.c)
+static const char glyph_ramp[] = "  __--<<\\/\\/~~##░░▒▒▓▓████████"; // " .'`^\",:;Il!i><~+_-?][}{1)(|\\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$";
 
 static char* output_buffer;
 static size_t output_buffer_size;
 
+// Rows are written I_ASCIIRowSize() apart so JS can slice row N at
+// N * row_stride without scanning for newlines.
+static size_t row_stride;
+
+// Dirty-row protocol (one entry per encoded row, at most
+// DOOMGENERIC_RESY of them): row_len holds the text length of every row and
+// dirty_rows lists the rows that changed since the last frame; only
+// those are handed to update_ascii_frame.
+static uint32_t row_hash[DOOMGENERIC_RESY];
+static int32_t row_len[DOOMGENERIC_RESY];
+static int32_t dirty_rows[DOOMGENERIC_RESY];
+static int rows_valid = 0;
+
 static unsigned char input_buffer[INPUT_BUFFER_LEN];
 static uint16_t event_buffer[EVENT_BUFFER_LEN];
 static uint16_t* event_buf_loc;
 
+// FNV-1a over one encoded row
+static uint32_t RowHash(const char* p, const char* end)
+{
+	uint32_t h = 2166136261u;
+
+	while (p < end)
+	{
+		h ^= (unsigned char)*p++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
 void DG_AtExit(void)
 {
 #ifdef OS_WINDOWS
@@ -163,20 +202,45 @@ void DG_AtExit(void)
 void DG_Init()
 {
 	start_time = get_time();
+	DG_GetLiveTicksMs = get_live_ticks_ms;
+
+	/* PDF viewers draw slowly; run up to half a second of tics per
+	 * frame rather than slow the game down */
+	DG_MaxTicBatch = 17;
+
+#ifdef FRAME_LIMITING
+	/* d_main.c skips drawing between presented frames */
+	DG_FrameIntervalMs = TARGET_FRAME_TIME;
+#endif
+
+	ascii_config_t config;
 
-	/* Longest SGR code: \033[38;2;RRR;GGG;BBBm (length 19)
-	 * Maximum 21 bytes per pixel: SGR + 2 x char
-	 * 1 Newline character per line
-	 * SGR clear code: \033[0m (length 4)
-	 */
-#ifdef USE_COLOR 
-	 // 21u represents the maximum number of bytes needed per pixel for the ASCII color escape sequence
-	 // +4u is for the start/end color-escape sequences + newline 
-	output_buffer_size = 21u * DOOMGENERIC_RESX * DOOMGENERIC_RESY + DOOMGENERIC_RESY + 4u;
+#if defined(BRAILLE)
+	config.cell = ASCII_CELL_BRAILLE;
+#elif defined(HALF_BLOCKS)
+	config.cell = ASCII_CELL_HALFBLOCK;
 #else
-	 // RB: orig is 4 bytes per "pixel" for regular no-color ascii
-	output_buffer_size = 4u * DOOMGENERIC_RESX * DOOMGENERIC_RESY + DOOMGENERIC_RESY + 1;  // only need +1 for \n termination, no color terms
+	config.cell = ASCII_CELL_RAMP;
 #endif
+	config.ramp = glyph_ramp;
+#if defined(USE_COLOR)
+	config.color = ASCII_TRUECOLOR;
+#elif defined(USE_COLOR_256)
+	config.color = ASCII_256COLOR;
+#elif defined(USE_COLOR_16)
+	config.color = ASCII_16COLOR;
+#else
+	config.color = ASCII_MONO;
+#endif
+#ifdef DOUBLE_CHAR_ASPECT // RB: account for char-width
+	config.aspect = 2;
+#else
+	config.aspect = 1;
+#endif
+	I_ASCIIConfigure(&config);
+
+	row_stride = I_ASCIIRowSize();
+	output_buffer_size = I_ASCIIFrameSize();
 
 	// Allocate pixel buffer in memory - just ram it in there ok?
 	output_buffer = malloc(output_buffer_size);
@@ -209,14 +273,17 @@ void DG_DrawFrame()
 	sum_frame_time += frame_time;
 	frame_count++;
 
-	// Frame-rate Limiting
-#ifdef FRAME_LIMITING
-	if (frame_time < TARGET_FRAME_TIME)
+#ifdef FPS_LOG
+	if (frame_count % fps_log_interval == 0)
 	{
-		return;
+		uint32_t avg_frame_time = sum_frame_time / fps_log_interval;
+		uint32_t fps = avg_frame_time > 0 ? 1000 / avg_frame_time : 0;
+		printf("Frame-time: %d ms\n", avg_frame_time);
+		printf("Framerate: %d FPS\n", fps);
+		printf("Tics/frame: %.2f\n", framestats.frames > 0 ? (double)framestats.tics / framestats.frames : 0.0);
+		sum_frame_time = 0; // Reset accumulator
 	}
 #endif
-	last_frame_time = current_time;
 
 	/* Clear screen if first frame */
 	static int first_frame = 0;
@@ -227,86 +294,52 @@ void DG_DrawFrame()
 	}
 
 	/* fill output buffer */
-#ifdef USE_COLOR
-	uint32_t color = 0xFFFFFF00;
-#endif
-	unsigned row, col;
-	struct color_t* pixel = (struct color_t*)DG_ScreenBuffer;
+	unsigned row;
 	char* buf = output_buffer;
+	char* row_start;
+	uint32_t hash;
+	int dirty_count = 0;
 
-	// RB added comments
-	// Iterate through each row and column of the output resolution
-	for (row = 0; row < DOOMGENERIC_RESY; row++)
+	I_ASCIIBeginFrame();
+
+	for (row = 0; row < I_ASCIIRows(); row++)
 	{
-		for (col = 0; col < DOOMGENERIC_RESX; col++)
+		row_start = output_buffer + row * row_stride;
+		buf = I_ASCIIEncodeRow(row_start, I_VideoBuffer, row);
+
+		// Queue the row for JS only if its text changed
+		hash = RowHash(row_start, buf);
+		row_len[row] = buf - row_start;
+		if (!rows_valid || hash != row_hash[row])
 		{
-#ifdef USE_COLOR
-			// Check if color changed from previous pixel (comparing RGB, ignoring alpha)
-			if ((color ^ *(uint32_t*)pixel) & 0x00FFFFFF) {
-				// ANSI escape sequence for 24-bit RGB color:
-				// \033[38;2;R;G;B;m
-				*buf++ = '\033';  // Escape character
-				*buf++ = '[';     // Start ANSI sequence
-				*buf++ = '3';     // Foreground color
-				*buf++ = '8';     // 24-bit RGB mode
-				*buf++ = ';';
-				*buf++ = '2';     // RGB submode
-				*buf++ = ';';
-				BYTE_TO_TEXT(buf, pixel->r);  // Convert R value to ASCII
-				*buf++ = ';';
-				BYTE_TO_TEXT(buf, pixel->g);  // Convert G value to ASCII
-				*buf++ = ';';
-				BYTE_TO_TEXT(buf, pixel->b);  // Convert B value to ASCII
-				*buf++ = 'm';     // End sequence
-				color = *(uint32_t*)pixel;   // Store current color
-			}
-#endif
-			// Convert RGB to grayscale index into ASCII gradient array
-			char v_char = grad[(pixel->r + pixel->g + pixel->b) * grad_len / 765u];  // 765 = 255*3
-			*buf++ = v_char;	// Write the character
-#ifdef DOUBLE_CHAR_ASPECT // RB: account for char-width
-			* buf++ = v_char;	// Write a SECOND character, cause such chars are twice/double taller than their width
-#endif
-			pixel++;
+			row_hash[row] = hash;
+			dirty_rows[dirty_count++] = row;
 		}
+
 		*buf++ = '\n';           // End of row
 	}
+	rows_valid = 1;
 
 	// Reset terminal colors to default
-#ifdef USE_COLOR
-	*buf++ = '\033';
-	*buf++ = '[';
-	*buf++ = '0';
-	*buf = 'm';
-#endif
-
-	// Combine input processing and frame update
-	EM_ASM({
-		// 1. Process input queue
-		// clang-format off
-		for (let key of Object.keys(pressed_keys)) {
-			key_queue.push([key, !!pressed_keys[key]]);
-			if (pressed_keys[key] == = 0)
-				delete pressed_keys[key];
-			if (pressed_keys[key] == = 2)
-				pressed_keys[key] = 0;
-			// clang-format on
-	}
+	I_ASCIIEndFrame(buf);
 
-	// 2. Update ASCII frame
-	update_ascii_frame($0, $1, $2, $3); }, output_buffer, output_buffer_size, DOOMGENERIC_RESX, DOOMGENERIC_RESY);
+	// The one call into JS per frame; input arrives through js_bridge
+	EM_ASM({ update_ascii_frame($0, $1, $2, $3, $4, $5); },
+	       output_buffer, row_stride, row_len, dirty_rows, dirty_count, I_ASCIIRows());
 
 	/* doom-ascii move cursor to top left corner and set bold text*/
 	// CALL_STDOUT(fputs("\033[;H\033[1m", stdout), "DG_DrawFrame: doomge error %d
 	/* doom-ascii flush output buffer */
 	// CALL_STDOUT(fputs(output_buffer, stdout), "DG_DrawFrame: fputs error %d");
-
-	/* clear output buffer */
-	memset(output_buffer, '\0', buf - output_buffer + 1u);
 }
 
 
-void DG_SleepMs(uint32_t ms) {}
+// Nothing to sleep on in a PDF viewer, but TryRunTics waits here for
+// the clock to move, so fetch a fresh one.
+void DG_SleepMs(uint32_t ms)
+{
+	EM_ASM({ bridge_set_time(); });
+}
 
 
 #ifdef OS_WINDOWS
@@ -513,20 +546,14 @@ static inline unsigned char convertToDoomKey(const char** const buf)
 
 int DG_GetKey(int* pressed, unsigned char* doomKey)
 {
-	int key_data = EM_ASM_INT({
-		// clang-format off
-		if (key_queue.length == = 0)
-		  return 0;
-		let key_data = key_queue.shift();
-		let key = key_data[0];
-		let pressed = key_data[1];
-		return (pressed << 8) | key;
-		// clang-format on
-		});
+	uint16_t key_data;
 
-	if (key_data == 0)
+	if (js_bridge.key_tail == js_bridge.key_head)
 		return 0;
 
+	key_data = js_bridge.keys[js_bridge.key_tail % KEY_RING_LEN];
+	js_bridge.key_tail++;
+
 	*pressed = key_data >> 8;
 	*doomKey = key_data & 0xFF;
 	return 1;
@@ -562,14 +589,33 @@ void DG_SetWindowTitle(const char* const title) { }
 
 
 void doomjs_tick() {
-	int start = get_time();
 	doomgeneric_Tick();
-	int end = get_time();
-	frame_count++;
+}
 
-	if (frame_count % 30 == 0) {
-		int fps = 1000 / (end - start);
-		printf("frame time: %i ms (%i fps)\n", end - start, fps);
+// The IWAD and PWAD from file_template.js stay base64 in JS, and
+// stream_read (pre.js) decodes just the ranges the engine reads: the
+// directory at startup, each lump when it is first cached.
+#define NUM_STREAM_FILES 2
+
+static char stream_names[NUM_STREAM_FILES][16];
+
+static size_t ReadStreamFile(void* handle, unsigned int offset, void* buffer, size_t buffer_len)
+{
+	return EM_ASM_INT({ return stream_read($0, $1, $2, $3); },
+	                  (int)(intptr_t)handle, offset, buffer, buffer_len);
+}
+
+static void AddStreamFiles(void)
+{
+	int i;
+	int length;
+
+	for (i = 0; i < NUM_STREAM_FILES; i++)
+	{
+		length = EM_ASM_INT({ return stream_open($0, $1, $2); },
+		                    i, stream_names[i], sizeof(stream_names[i]));
+		if (length > 0)
+			W_AddStreamFile(stream_names[i], length, ReadStreamFile, (void*)(intptr_t)i);
 	}
 }
 
@@ -579,18 +625,14 @@ int main(int argc, char** argv)
 	// N/A (implemented in c, here)
 	// EM_ASM({ create_framebuffer($0, $1); }, DOOMGENERIC_RESX, DOOMGENERIC_RESY);
 
-	EM_ASM({
-	  write_file(file_name, file_data);
-	  if (file2_data)
-	  {
-		write_file(file2_name, file2_data);
-	  }
-		});
+	EM_ASM({ bridge_init($0); }, &js_bridge);
+
+	AddStreamFiles();
 
 	doomgeneric_Create(argc, argv);
 
 	EM_ASM({
-	   app.setInterval("_doomjs_tick()", 0);
+	   app.setInterval("doom_tick()", 0);
 		});
 
 	return 0;
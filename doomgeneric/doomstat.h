@@ -197,6 +197,9 @@ extern boolean lowres_turn;
 // Quit after playing a demo from cmdline.
 extern  boolean		singledemo;	
 
+// Timing a demo from cmdline (-timedemo); cleared when it ends.
+extern  boolean		timingdemo;
+
 
 
 
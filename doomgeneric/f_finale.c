@@ -242,19 +242,13 @@ void F_TextWrite (void)
 	
     for (y=0 ; y<SCREENHEIGHT ; y++)
     {
-	for (x=0 ; x<SCREENWIDTH/64 ; x++)
+	for (x=0 ; x<SCREENWIDTH ; x++)
 	{
-	    memcpy (dest, src+((y&63)<<6), 64);
-	    dest += 64;
-	}
-	if (SCREENWIDTH&63)
-	{
-	    memcpy (dest, src+((y&63)<<6), SCREENWIDTH&63);
-	    dest += (SCREENWIDTH&63);
+	    *dest++ = src[(((y<<LOWRES)&63)<<6) + ((x<<LOWRES)&63)];
 	}
     }
 
-    V_MarkRect (0, 0, SCREENWIDTH, SCREENHEIGHT);
+    V_MarkRect (0, 0, ORIGWIDTH, ORIGHEIGHT);
     
     // draw some of the text onto the screen
     cx = 10;
@@ -284,7 +278,7 @@ void F_TextWrite (void)
 	}
 		
 	w = SHORT (hu_font[c]->width);
-	if (cx+w > SCREENWIDTH)
+	if (cx+w > ORIGWIDTH)
 	    break;
 	V_DrawPatch(cx, cy, hu_font[c]);
 	cx+=w;
@@ -579,20 +573,24 @@ F_DrawPatchCol
     byte*	dest;
     byte*	desttop;
     int		count;
+    int		top;
 	
     column = (column_t *)((byte *)patch + LONG(patch->columnofs[col]));
     desttop = I_VideoBuffer + x;
 
-    // step through the posts in a column
+    // step through the posts in a column, sampling every
+    // (1 << LOWRES)th row
     while (column->topdelta != 0xff )
     {
-	source = (byte *)column + 3;
-	dest = desttop + column->topdelta*SCREENWIDTH;
-	count = column->length;
+	top = SCREENCOORD(column->topdelta);
+	source = (byte *)column + 3 + (top << LOWRES) - column->topdelta;
+	dest = desttop + top*SCREENWIDTH;
+	count = SCREENCOORD(column->topdelta + column->length) - top;
 		
 	while (count--)
 	{
-	    *dest = *source++;
+	    *dest = *source;
+	    source += 1 << LOWRES;
 	    dest += SCREENWIDTH;
 	}
 	column = (column_t *)(  (byte *)column + column->length + 4 );
@@ -607,6 +605,7 @@ void F_BunnyScroll (void)
 {
     signed int  scrolled;
     int		x;
+    int		col;
     patch_t*	p1;
     patch_t*	p2;
     char	name[10];
@@ -616,7 +615,7 @@ void F_BunnyScroll (void)
     p1 = W_CacheLumpName (DEH_String("PFUB2"), PU_LEVEL);
     p2 = W_CacheLumpName (DEH_String("PFUB1"), PU_LEVEL);
 
-    V_MarkRect (0, 0, SCREENWIDTH, SCREENHEIGHT);
+    V_MarkRect (0, 0, ORIGWIDTH, ORIGHEIGHT);
 	
     scrolled = (320 - ((signed int) finalecount-230)/2);
     if (scrolled > 320)
@@ -626,18 +625,20 @@ void F_BunnyScroll (void)
 		
     for ( x=0 ; x<SCREENWIDTH ; x++)
     {
-	if (x+scrolled < 320)
-	    F_DrawPatchCol (x, p1, x+scrolled);
+	col = (x << LOWRES) + scrolled;
+
+	if (col < 320)
+	    F_DrawPatchCol (x, p1, col);
 	else
-	    F_DrawPatchCol (x, p2, x+scrolled - 320);		
+	    F_DrawPatchCol (x, p2, col - 320);		
     }
 	
     if (finalecount < 1130)
 	return;
     if (finalecount < 1180)
     {
-        V_DrawPatch((SCREENWIDTH - 13 * 8) / 2,
-                    (SCREENHEIGHT - 8 * 8) / 2, 
+        V_DrawPatch((ORIGWIDTH - 13 * 8) / 2,
+                    (ORIGHEIGHT - 8 * 8) / 2, 
                     W_CacheLumpName(DEH_String("END0"), PU_CACHE));
 	laststage = 0;
 	return;
@@ -653,8 +654,8 @@ void F_BunnyScroll (void)
     }
 	
     DEH_snprintf(name, 10, "END%i", stage);
-    V_DrawPatch((SCREENWIDTH - 13 * 8) / 2, 
-                (SCREENHEIGHT - 8 * 8) / 2, 
+    V_DrawPatch((ORIGWIDTH - 13 * 8) / 2, 
+                (ORIGHEIGHT - 8 * 8) / 2, 
                 W_CacheLumpName (name,PU_CACHE));
 }
 
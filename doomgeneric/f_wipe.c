@@ -174,9 +174,15 @@ wipe_doMelt
     short*	s;
     short*	d;
     boolean	done = true;
+    int		origheight;
+    int		y0, y1;
 
     width/=2;
 
+    // Column progress is tracked in original rows so that the
+    // melt takes the same time at any render resolution.
+    origheight = height << LOWRES;
+
     while (ticks--)
     {
 	for (i=0;i<width;i++)
@@ -185,23 +191,25 @@ wipe_doMelt
 	    {
 		y[i]++; done = false;
 	    }
-	    else if (y[i] < height)
+	    else if (y[i] < origheight)
 	    {
 		dy = (y[i] < 16) ? y[i]+1 : 8;
-		if (y[i]+dy >= height) dy = height - y[i];
-		s = &((short *)wipe_scr_end)[i*height+y[i]];
-		d = &((short *)wipe_scr)[y[i]*width+i];
+		if (y[i]+dy >= origheight) dy = origheight - y[i];
+		y0 = SCREENCOORD(y[i]);
+		y1 = SCREENCOORD(y[i] + dy);
+		s = &((short *)wipe_scr_end)[i*height+y0];
+		d = &((short *)wipe_scr)[y0*width+i];
 		idx = 0;
-		for (j=dy;j;j--)
+		for (j=y1-y0;j;j--)
 		{
 		    d[idx] = *(s++);
 		    idx += width;
 		}
 		y[i] += dy;
 		s = &((short *)wipe_scr_start)[i*height];
-		d = &((short *)wipe_scr)[y[i]*width+i];
+		d = &((short *)wipe_scr)[y1*width+i];
 		idx = 0;
-		for (j=height-y[i];j;j--)
+		for (j=height-y1;j;j--)
 		{
 		    d[idx] = *(s++);
 		    idx += width;
@@ -71,6 +71,7 @@
 
 
 #include "g_game.h"
+#include "i_profile.h"
 
 
 #define SAVEGAMESIZE	0x2c000
@@ -1005,7 +1006,9 @@ void G_Ticker (void)
     switch (gamestate) 
     { 
       case GS_LEVEL: 
+	PROFILE_BEGIN(PROF_TICKER);
 	P_Ticker (); 
+	PROFILE_END(PROF_TICKER);
 	ST_Ticker (); 
 	AM_Ticker (); 
 	HU_Ticker ();            
@@ -0,0 +1,248 @@
+//
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Micro-benchmark for the text frame encoder in i_ascii.c:
+//      every glyph kernel, every encoder mode, then the cell diff.
+//      Build with "make -f Makefile.bench", run ./glyphbench [frames].
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "doomgeneric.h"
+#include "i_ascii.h"
+
+#define BENCH_WIDTH  DOOMGENERIC_RESX
+#define BENCH_HEIGHT DOOMGENERIC_RESY
+
+static const char ascii_ramp[] =
+    " .'`^\",:;Il!i><~+_-?][}{1)(|\\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$";
+static const char utf8_ramp[] = "  __--<<\\/\\/~~##░░▒▒▓▓████████";
+
+static byte frame[BENCH_WIDTH * BENCH_HEIGHT];
+static byte moved[BENCH_WIDTH * BENCH_HEIGHT];
+static uint32_t palette[256];
+
+static char *out;
+static char *ref;
+
+static const char *color_names[] = { "mono", "truecolor", "256", "16" };
+
+static double Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void Configure(ascii_cell_t cell, const char *ramp,
+                      ascii_color_t color, int aspect)
+{
+    ascii_config_t config;
+
+    config.cell = cell;
+    config.ramp = ramp;
+    config.color = color;
+    config.aspect = aspect;
+    I_ASCIIConfigure(&config);
+}
+
+static size_t EncodeGlyphs(glyph_kernel_t encode, int repeat)
+{
+    char *buf = out;
+    int row;
+
+    for (row = 0; row < BENCH_HEIGHT; ++row)
+    {
+        buf = encode(buf, frame + row * BENCH_WIDTH, BENCH_WIDTH, repeat);
+        *buf++ = '\n';
+    }
+
+    return buf - out;
+}
+
+// Every kernel that applies to the ramp, checked against the cell copy.
+
+static void BenchKernels(const char *label, const char *ramp,
+                         boolean narrow, int frames, int repeat)
+{
+    const glyph_kernel_info_t *k;
+    size_t ref_len, len;
+    double start, elapsed;
+    int i;
+
+    Configure(ASCII_CELL_RAMP, ramp, ASCII_MONO, repeat);
+    ref_len = EncodeGlyphs(glyph_kernels[0].encode, repeat);
+    memcpy(ref, out, ref_len);
+
+    for (k = glyph_kernels; k->name != NULL; ++k)
+    {
+        if ((k->narrow && !narrow) || !k->supported())
+        {
+            continue;
+        }
+
+        len = EncodeGlyphs(k->encode, repeat);
+
+        if (len != ref_len || memcmp(out, ref, len) != 0)
+        {
+            printf("kernel %-6s x%d %-12s MISMATCH\n", label, repeat, k->name);
+            exit(1);
+        }
+
+        start = Now();
+        for (i = 0; i < frames; ++i)
+        {
+            EncodeGlyphs(k->encode, repeat);
+        }
+        elapsed = Now() - start;
+
+        printf("kernel %-6s x%d %-12s %8.1f Mpixels/s %8.0f ns/frame %7d bytes/frame\n",
+               label, repeat, k->name,
+               (double) frames * BENCH_WIDTH * BENCH_HEIGHT / elapsed / 1e6,
+               elapsed / frames * 1e9, (int) len);
+    }
+}
+
+// A whole frame through the public encoder API.
+
+static void BenchMode(const char *label, ascii_cell_t cell, const char *ramp,
+                      ascii_color_t color, int aspect, int frames)
+{
+    size_t len = 0;
+    double start, elapsed;
+    int i;
+
+    Configure(cell, ramp, color, aspect);
+
+    if (I_ASCIIDiffSize() > (size_t) BENCH_WIDTH * BENCH_HEIGHT * 64)
+    {
+        printf("mode   %-6s too large\n", label);
+        exit(1);
+    }
+
+    start = Now();
+    for (i = 0; i < frames; ++i)
+    {
+        len = I_ASCIIEncodeFrame(out, frame);
+    }
+    elapsed = Now() - start;
+
+    printf("mode   %-6s %-9s x%d %8.0f ns/frame %7d bytes/frame (max %d)\n",
+           label, color_names[color], aspect,
+           elapsed / frames * 1e9, (int) len, (int) I_ASCIIFrameSize());
+}
+
+// Cell diff between frames that differ by a moving 32x32 block,
+// about 6% of the pixels.
+
+static void BenchDiff(const char *label, ascii_cell_t cell, const char *ramp,
+                      ascii_color_t color, int aspect, int frames)
+{
+    size_t len, total = 0;
+    double start, elapsed;
+    int i, y, x;
+
+    Configure(cell, ramp, color, aspect);
+    I_ASCIIEncodeDiff(out, frame);
+
+    start = Now();
+    for (i = 0; i < frames; ++i)
+    {
+        memcpy(moved, frame, sizeof(moved));
+        x = (i * 8) % (BENCH_WIDTH - 32);
+
+        for (y = 32; y < 64; ++y)
+        {
+            memset(moved + y * BENCH_WIDTH + x, 0xff, 32);
+        }
+
+        len = I_ASCIIEncodeDiff(out, moved);
+        total += len;
+    }
+    elapsed = Now() - start;
+
+    printf("diff   %-6s %-9s x%d %8.0f ns/frame %7d bytes/frame (max %d)\n",
+           label, color_names[color], aspect,
+           elapsed / frames * 1e9, (int) (total / frames),
+           (int) I_ASCIIDiffSize());
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 2000;
+    int i, run, index;
+
+    out = malloc(BENCH_WIDTH * BENCH_HEIGHT * 64);
+    ref = malloc(BENCH_WIDTH * BENCH_HEIGHT * 64);
+
+    // A grey ramp, so palette index is brightness.
+    for (i = 0; i < 256; ++i)
+    {
+        palette[i] = (i << 16) | (i << 8) | i;
+    }
+    I_ASCIISetPalette(palette);
+
+    // Runs of 1-16 equal pixels, roughly the texture of a rendered
+    // frame, so colour modes see realistic escape counts.
+    srand(666);
+    for (i = 0; i < BENCH_WIDTH * BENCH_HEIGHT; i += run)
+    {
+        run = 1 + rand() % 16;
+        index = rand() & 0xff;
+
+        if (run > BENCH_WIDTH * BENCH_HEIGHT - i)
+        {
+            run = BENCH_WIDTH * BENCH_HEIGHT - i;
+        }
+
+        memset(frame + i, index, run);
+    }
+
+    printf("%dx%d, %d frames\n", BENCH_WIDTH, BENCH_HEIGHT, frames);
+
+    for (i = 1; i <= 2; ++i)
+    {
+        BenchKernels("ascii", ascii_ramp, true, frames, i);
+        BenchKernels("utf-8", utf8_ramp, false, frames, i);
+    }
+
+    for (i = 1; i <= 2; ++i)
+    {
+        BenchMode("ascii", ASCII_CELL_RAMP, ascii_ramp, ASCII_MONO, i, frames);
+        BenchMode("utf-8", ASCII_CELL_RAMP, utf8_ramp, ASCII_MONO, i, frames);
+        BenchMode("utf-8", ASCII_CELL_RAMP, utf8_ramp, ASCII_TRUECOLOR, i, frames);
+        BenchMode("utf-8", ASCII_CELL_RAMP, utf8_ramp, ASCII_256COLOR, i, frames);
+        BenchMode("utf-8", ASCII_CELL_RAMP, utf8_ramp, ASCII_16COLOR, i, frames);
+    }
+
+    BenchMode("half", ASCII_CELL_HALFBLOCK, "", ASCII_MONO, 1, frames);
+    BenchMode("half", ASCII_CELL_HALFBLOCK, "", ASCII_TRUECOLOR, 1, frames);
+    BenchMode("half", ASCII_CELL_HALFBLOCK, "", ASCII_256COLOR, 1, frames);
+    BenchMode("half", ASCII_CELL_HALFBLOCK, "", ASCII_16COLOR, 1, frames);
+    BenchMode("dots", ASCII_CELL_BRAILLE, "", ASCII_MONO, 1, frames);
+    BenchMode("dots", ASCII_CELL_BRAILLE, "", ASCII_TRUECOLOR, 1, frames);
+
+    BenchDiff("utf-8", ASCII_CELL_RAMP, utf8_ramp, ASCII_MONO, 2, frames);
+    BenchDiff("utf-8", ASCII_CELL_RAMP, utf8_ramp, ASCII_TRUECOLOR, 2, frames);
+    BenchDiff("half", ASCII_CELL_HALFBLOCK, "", ASCII_TRUECOLOR, 1, frames);
+    BenchDiff("dots", ASCII_CELL_BRAILLE, "", ASCII_TRUECOLOR, 1, frames);
+
+    return 0;
+}
+
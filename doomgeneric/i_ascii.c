@@ -0,0 +1,1162 @@
+//
+// Copyright(C) 2022-2024 Wojciech Graj
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Text frame encoder shared by the CMAP_GLYPH backends.
+//
+//      Brightness is resolved per palette entry in I_SetPalette, so
+//      the per-pixel work left is a glyph_lut lookup and a store.
+//      Ramps of multi-byte UTF-8 glyphs produce variable-length
+//      output and always use the scalar cell-copy kernel. When every
+//      glyph is one byte the output is fixed-width and the vector
+//      kernels below handle 16 pixels per iteration.
+//
+//      Half-block and Braille cells pack 1x2 and 2x4 pixels into one
+//      character. Without colour each pixel is an on/off dot, chosen
+//      by ordered dithering of its brightness.
+//
+//      There is no SSE2 kernel: without a byte gather the lookups
+//      stay scalar, and glyphbench showed it no faster than the
+//      plain narrow loop.
+//
+
+#include <string.h>
+
+#include "doomgeneric.h"
+#include "i_ascii.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+#ifdef __wasm_simd128__
+#define HAVE_WASM_SIMD
+#include <wasm_simd128.h>
+#endif
+
+// Longest SGR code: \033[38;2;RRR;GGG;BBBm
+
+#define SGR_TRUECOLOR_LEN 19
+
+// Foreground and background at once: \033[38;2;RRR;GGG;BBB;48;2;RRR;GGG;BBBm
+
+#define SGR_TRUECOLOR_PAIR_LEN 36
+
+// The same for xterm-256 colour numbers: \033[38;5;NNNm
+
+#define SGR_256_LEN 11
+#define SGR_256_PAIR_LEN 20
+
+// And for the 16 ANSI colours: \033[97m, \033[97;107m
+
+#define SGR_16_LEN 5
+#define SGR_16_PAIR_LEN 10
+
+// Half blocks and Braille patterns are all 3 bytes of UTF-8.
+
+#define PACKED_GLYPH_LEN 3
+
+// SGR clear code: \033[0m
+
+#define SGR_RESET_LEN 4
+
+// "\033[RRRRR;CCCCCH", cursor position for coordinates up to 5 digits.
+
+#define CUP_LEN 14
+
+// Unchanged cells the diff encoder may rewrite to join two runs, when
+// that is shorter than moving the cursor past them.
+
+#define MAX_GAP 4
+
+glyph_t glyph_lut[256];
+uint32_t color_lut[256];
+
+static ascii_config_t config = { ASCII_CELL_RAMP, "", ASCII_MONO, 1 };
+
+// Start of every glyph in config.ramp.
+static const char *ramp_glyphs[256];
+static int ramp_len;
+
+// Longest glyph in config.ramp, in bytes.
+static int glyph_width;
+
+static glyph_kernel_t encode_glyphs;
+
+// Colours last selected, or 0xffffffff at frame start.
+static uint32_t current_fg;
+static uint32_t current_bg;
+
+// Palette index -> brightness, 0-255.
+static byte luma_lut[256];
+
+// Palette as last passed to I_ASCIISetPalette, 0xRRGGBB.
+static uint32_t palette_rgb[256];
+
+// Dot pattern -> Braille glyph, bit n set for dot n+1.
+static glyph_t braille_lut[256];
+
+// Mono half blocks, indexed by (top on) | (bottom on) << 1.
+static const glyph_t half_blocks[4] =
+{
+    { " ",            1 },
+    { "\xe2\x96\x80", 3 },     // U+2580 upper half block
+    { "\xe2\x96\x84", 3 },     // U+2584 lower half block
+    { "\xe2\x96\x88", 3 },     // U+2588 full block
+};
+
+// 4x4 ordered dither thresholds.
+static const byte bayer[4][4] =
+{
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+#define DOT(index, x, y) (luma_lut[index] > (bayer[(y) & 3][(x) & 3] << 4) + 8)
+
+static int AlwaysSupported(void)
+{
+    return 1;
+}
+
+//
+// Scalar kernels
+//
+
+// Any ramp: copy the whole pre-encoded cell, advance by its length.
+
+static char *EncodeCells(char *dst, const byte *src, int count, int repeat)
+{
+    const glyph_t *glyph;
+
+    while (count-- > 0)
+    {
+        glyph = &glyph_lut[*src++];
+
+        memcpy(dst, glyph->bytes, GLYPH_CELL);
+        dst += glyph->len;
+
+        if (repeat > 1)
+        {
+            memcpy(dst, glyph->bytes, GLYPH_CELL);
+            dst += glyph->len;
+        }
+    }
+
+    return dst;
+}
+
+// Single-byte ramps: one byte per glyph, no length to track.
+
+static char *EncodeNarrow(char *dst, const byte *src, int count, int repeat)
+{
+    int i;
+
+    if (repeat > 1)
+    {
+        for (i = 0; i < count; ++i)
+        {
+            dst[2 * i] = dst[2 * i + 1] = glyph_lut[src[i]].bytes[0];
+        }
+    }
+    else
+    {
+        for (i = 0; i < count; ++i)
+        {
+            dst[i] = glyph_lut[src[i]].bytes[0];
+        }
+    }
+
+    return dst + count * repeat;
+}
+
+//
+// AVX2: two 8-wide gathers fetch the first byte of 16 glyph cells
+// straight out of glyph_lut.
+//
+
+#ifdef HAVE_AVX2
+
+__attribute__((target("avx2")))
+static char *EncodeNarrowAVX2(char *dst, const byte *src, int count,
+                              int repeat)
+{
+    const __m256i stride = _mm256_set1_epi32(sizeof(glyph_t));
+    const __m256i low_byte = _mm256_set1_epi32(0xff);
+    __m256i idx0, idx1, g0, g1;
+    __m128i words0, words1, v;
+
+    for (; count >= 16; count -= 16, src += 16)
+    {
+        idx0 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) src));
+        idx1 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + 8)));
+
+        g0 = _mm256_i32gather_epi32((const int *) glyph_lut,
+                                    _mm256_mullo_epi32(idx0, stride), 1);
+        g1 = _mm256_i32gather_epi32((const int *) glyph_lut,
+                                    _mm256_mullo_epi32(idx1, stride), 1);
+        g0 = _mm256_and_si256(g0, low_byte);
+        g1 = _mm256_and_si256(g1, low_byte);
+
+        // 32 -> 16 -> 8 bits; packs work per 128-bit lane, so pair
+        // the halves of each gather before narrowing.
+        words0 = _mm_packus_epi32(_mm256_castsi256_si128(g0),
+                                  _mm256_extracti128_si256(g0, 1));
+        words1 = _mm_packus_epi32(_mm256_castsi256_si128(g1),
+                                  _mm256_extracti128_si256(g1, 1));
+        v = _mm_packus_epi16(words0, words1);
+
+        if (repeat > 1)
+        {
+            _mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi8(v, v));
+            _mm_storeu_si128((__m128i *) (dst + 16), _mm_unpackhi_epi8(v, v));
+            dst += 32;
+        }
+        else
+        {
+            _mm_storeu_si128((__m128i *) dst, v);
+            dst += 16;
+        }
+    }
+
+    return EncodeNarrow(dst, src, count, repeat);
+}
+
+static int AVX2Supported(void)
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif // HAVE_AVX2
+
+//
+// wasm SIMD has no byte gather either, so the lookups stay scalar and
+// are assembled in registers; the vector unit does the doubling and
+// the 16-byte stores. For -msimd128 builds.
+//
+
+#ifdef HAVE_WASM_SIMD
+
+static char *EncodeNarrowWasm(char *dst, const byte *src, int count,
+                              int repeat)
+{
+    uint64_t lo, hi;
+    v128_t v;
+    int i;
+
+    for (; count >= 16; count -= 16, src += 16)
+    {
+        lo = hi = 0;
+        for (i = 7; i >= 0; --i)
+        {
+            lo = (lo << 8) | (byte) glyph_lut[src[i]].bytes[0];
+            hi = (hi << 8) | (byte) glyph_lut[src[i + 8]].bytes[0];
+        }
+
+        v = wasm_i64x2_make(lo, hi);
+
+        if (repeat > 1)
+        {
+            wasm_v128_store(dst, wasm_i8x16_shuffle(v, v, 0, 0, 1, 1, 2, 2,
+                                                    3, 3, 4, 4, 5, 5, 6, 6,
+                                                    7, 7));
+            wasm_v128_store(dst + 16, wasm_i8x16_shuffle(v, v, 8, 8, 9, 9,
+                                                         10, 10, 11, 11, 12,
+                                                         12, 13, 13, 14, 14,
+                                                         15, 15));
+            dst += 32;
+        }
+        else
+        {
+            wasm_v128_store(dst, v);
+            dst += 16;
+        }
+    }
+
+    return EncodeNarrow(dst, src, count, repeat);
+}
+
+#endif // HAVE_WASM_SIMD
+
+// Slowest first; I_GlyphKernel takes the last supported match.
+
+const glyph_kernel_info_t glyph_kernels[] =
+{
+    { "cells",       EncodeCells,      false, AlwaysSupported },
+    { "narrow",      EncodeNarrow,     true,  AlwaysSupported },
+#ifdef HAVE_WASM_SIMD
+    { "narrow-wasm", EncodeNarrowWasm, true,  AlwaysSupported },
+#endif
+#ifdef HAVE_AVX2
+    { "narrow-avx2", EncodeNarrowAVX2, true,  AVX2Supported },
+#endif
+    { NULL,          NULL,             false, NULL },
+};
+
+glyph_kernel_t I_GlyphKernel(boolean narrow)
+{
+    glyph_kernel_t best = EncodeCells;
+    int i;
+
+    for (i = 0; glyph_kernels[i].name != NULL; ++i)
+    {
+        if ((narrow || !glyph_kernels[i].narrow)
+         && glyph_kernels[i].supported())
+        {
+            best = glyph_kernels[i].encode;
+        }
+    }
+
+    return best;
+}
+
+//
+// Glyph tables
+//
+
+// Length of the UTF-8 sequence starting with lead byte c.
+
+static int GlyphLength(unsigned char c)
+{
+    if (c < 0x80)
+        return 1;
+    else if (c < 0xe0)
+        return 2;
+    else if (c < 0xf0)
+        return 3;
+    else
+        return 4;
+}
+
+// Pick each entry's glyph by brightness once here rather than per
+// pixel in the encoder. The ramp is UTF-8, so it is indexed by
+// glyph, never by byte.
+
+static void BuildGlyphs(void)
+{
+    const char *glyph;
+    uint32_t c;
+    int i;
+
+    for (i = 0; i < 256; ++i)
+    {
+        c = palette_rgb[i];
+        luma_lut[i] = ((c >> 16) + ((c >> 8) & 0xff) + (c & 0xff)) / 3;
+    }
+
+    if (ramp_len == 0)
+    {
+        return;
+    }
+
+    for (i = 0; i < 256; ++i)
+    {
+        glyph = ramp_glyphs[luma_lut[i] * ramp_len / 256];
+
+        memset(&glyph_lut[i], 0, sizeof(glyph_t));
+        glyph_lut[i].len = GlyphLength((unsigned char) *glyph);
+        memcpy(glyph_lut[i].bytes, glyph, glyph_lut[i].len);
+    }
+}
+
+// U+2800 + pattern, as UTF-8.
+
+static void BuildBraille(void)
+{
+    int i;
+
+    for (i = 0; i < 256; ++i)
+    {
+        braille_lut[i].bytes[0] = (char) 0xe2;
+        braille_lut[i].bytes[1] = (char) (0xa0 | (i >> 6));
+        braille_lut[i].bytes[2] = (char) (0x80 | (i & 0x3f));
+        braille_lut[i].bytes[3] = 0;
+        braille_lut[i].len = PACKED_GLYPH_LEN;
+    }
+}
+
+//
+// Colour quantisation
+//
+
+// Levels of the xterm-256 6x6x6 colour cube, colours 16-231.
+
+static const byte cube_levels[6] = { 0, 95, 135, 175, 215, 255 };
+
+// xterm's defaults for the 16 ANSI colours.
+
+static const uint32_t ansi_colors[16] =
+{
+    0x000000, 0xcd0000, 0x00cd00, 0xcdcd00,
+    0x0000ee, 0xcd00cd, 0x00cdcd, 0xe5e5e5,
+    0x7f7f7f, 0xff0000, 0x00ff00, 0xffff00,
+    0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff,
+};
+
+// Squared distance, weighted roughly by the eye's sensitivity.
+
+static int ColorDistance(uint32_t a, uint32_t b)
+{
+    int dr = (int) (a >> 16) - (int) (b >> 16);
+    int dg = (int) ((a >> 8) & 0xff) - (int) ((b >> 8) & 0xff);
+    int db = (int) (a & 0xff) - (int) (b & 0xff);
+
+    return 3 * dr * dr + 4 * dg * dg + 2 * db * db;
+}
+
+static int CubeIndex(int c)
+{
+    return c < 48 ? 0 : c < 115 ? 1 : (c - 35) / 40;
+}
+
+static uint32_t CubeColor(int r, int g, int b)
+{
+    return cube_levels[r] << 16 | cube_levels[g] << 8 | cube_levels[b];
+}
+
+// Nearest of xterm-256 colours 16-255, which unlike 0-15 are the same
+// on every terminal.
+
+static int Nearest256(uint32_t rgb)
+{
+    int r = CubeIndex(rgb >> 16);
+    int g = CubeIndex((rgb >> 8) & 0xff);
+    int b = CubeIndex(rgb & 0xff);
+    int luma = ((rgb >> 16) + ((rgb >> 8) & 0xff) + (rgb & 0xff)) / 3;
+    int grey = luma < 8 ? 0 : luma > 238 ? 23 : (luma - 3) / 10;
+    int level = 8 + grey * 10;
+
+    if (ColorDistance(rgb, level << 16 | level << 8 | level)
+      < ColorDistance(rgb, CubeColor(r, g, b)))
+    {
+        return 232 + grey;
+    }
+
+    return 16 + 36 * r + 6 * g + b;
+}
+
+static int Nearest16(uint32_t rgb)
+{
+    int i, best = 0;
+
+    for (i = 1; i < 16; ++i)
+    {
+        if (ColorDistance(rgb, ansi_colors[i])
+          < ColorDistance(rgb, ansi_colors[best]))
+        {
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+// xterm-256 colour number of rgb if it is exactly one of colours
+// 16-255, otherwise -1. Called on every colour change in truecolor.
+
+static int Exact256(uint32_t rgb)
+{
+    int r = rgb >> 16;
+    int g = (rgb >> 8) & 0xff;
+    int b = rgb & 0xff;
+
+    if (cube_levels[CubeIndex(r)] == r && cube_levels[CubeIndex(g)] == g
+     && cube_levels[CubeIndex(b)] == b)
+    {
+        return 16 + 36 * CubeIndex(r) + 6 * CubeIndex(g) + CubeIndex(b);
+    }
+
+    if (r == g && g == b && r >= 8 && r <= 238 && (r - 8) % 10 == 0)
+    {
+        return 232 + (r - 8) / 10;
+    }
+
+    return -1;
+}
+
+// color_lut holds what SGR codes are written from: the RGB itself in
+// truecolor, the colour number in the 256 and 16 colour modes. Equal
+// quantised colours compare equal, so their runs coalesce.
+
+static void BuildColors(void)
+{
+    int i;
+
+    for (i = 0; i < 256; ++i)
+    {
+        switch (config.color)
+        {
+            case ASCII_256COLOR:
+                color_lut[i] = Nearest256(palette_rgb[i]);
+                break;
+            case ASCII_16COLOR:
+                color_lut[i] = Nearest16(palette_rgb[i]);
+                break;
+            default:
+                color_lut[i] = palette_rgb[i];
+                break;
+        }
+    }
+}
+
+void I_ASCIISetPalette(const uint32_t *rgb)
+{
+    memcpy(palette_rgb, rgb, sizeof(palette_rgb));
+
+    BuildColors();
+    BuildGlyphs();
+    I_ASCIIInvalidate();
+}
+
+void I_ASCIIConfigure(const ascii_config_t *new_config)
+{
+    const char *p;
+    int len;
+
+    config = *new_config;
+
+    if (braille_lut[0].len == 0)
+    {
+        BuildBraille();
+    }
+
+    ramp_len = 0;
+    glyph_width = 1;
+
+    for (p = config.ramp; *p != '\0' && ramp_len < 256; p += len)
+    {
+        len = GlyphLength((unsigned char) *p);
+        if (len > glyph_width)
+            glyph_width = len;
+
+        ramp_glyphs[ramp_len++] = p;
+    }
+
+    encode_glyphs = I_GlyphKernel(glyph_width == 1);
+
+    BuildColors();
+    BuildGlyphs();
+    I_ASCIIInvalidate();
+}
+
+//
+// Frame encoding
+//
+
+int I_ASCIIRows(void)
+{
+    switch (config.cell)
+    {
+        case ASCII_CELL_HALFBLOCK:
+            return DOOMGENERIC_RESY / 2;
+        case ASCII_CELL_BRAILLE:
+            return DOOMGENERIC_RESY / 4;
+        default:
+            return DOOMGENERIC_RESY;
+    }
+}
+
+// Longest colour escape of the current mode, for one layer or both.
+
+static size_t SGRLength(boolean pair)
+{
+    switch (config.color)
+    {
+        case ASCII_TRUECOLOR:
+            return pair ? SGR_TRUECOLOR_PAIR_LEN : SGR_TRUECOLOR_LEN;
+        case ASCII_256COLOR:
+            return pair ? SGR_256_PAIR_LEN : SGR_256_LEN;
+        case ASCII_16COLOR:
+            return pair ? SGR_16_PAIR_LEN : SGR_16_LEN;
+        default:
+            return 0;
+    }
+}
+
+size_t I_ASCIIRowSize(void)
+{
+    size_t cell;
+    int cells = DOOMGENERIC_RESX;
+
+    switch (config.cell)
+    {
+        case ASCII_CELL_HALFBLOCK:
+            cell = PACKED_GLYPH_LEN + SGRLength(true);
+            break;
+
+        case ASCII_CELL_BRAILLE:
+            cell = PACKED_GLYPH_LEN + SGRLength(false);
+            cells = DOOMGENERIC_RESX / 2;
+            break;
+
+        default:
+            cell = config.aspect * glyph_width + SGRLength(false);
+            break;
+    }
+
+    return cell * cells + 1;
+}
+
+size_t I_ASCIIFrameSize(void)
+{
+    return I_ASCIIRowSize() * I_ASCIIRows() + SGR_RESET_LEN + GLYPH_CELL;
+}
+
+void I_ASCIIBeginFrame(void)
+{
+    current_fg = 0xffffffff;
+    current_bg = 0xffffffff;
+}
+
+static char *PutNumber(char *dst, int n)
+{
+    char digits[8];
+    int i = 0;
+
+    do
+    {
+        digits[i++] = '0' + n % 10;
+        n /= 10;
+    } while (n > 0);
+
+    while (i > 0)
+    {
+        *dst++ = digits[--i];
+    }
+
+    return dst;
+}
+
+// Decimal 0-255 without leading zeros.
+
+static char *PutByte(char *dst, unsigned int n)
+{
+    if (n >= 100)
+    {
+        *dst++ = '0' + n / 100;
+        n %= 100;
+        *dst++ = '0' + n / 10;
+    }
+    else if (n >= 10)
+    {
+        *dst++ = '0' + n / 10;
+    }
+
+    *dst++ = '0' + n % 10;
+
+    return dst;
+}
+
+// SGR parameters selecting color (a color_lut value) for the
+// foreground (layer '3') or background ('4'), in the shortest form
+// the mode allows: "3N"/"9N" for the 16 colours, "38;5;N" for xterm-256
+// and for RGB that is exactly an xterm-256 colour, else "38;2;R;G;B".
+
+static char *ColorParams(char *dst, char layer, uint32_t color)
+{
+    int n = -1;
+
+    if (config.color == ASCII_16COLOR)
+    {
+        if (color >= 8)
+        {
+            if (layer == '4')
+            {
+                *dst++ = '1';
+                *dst++ = '0';
+            }
+            else
+            {
+                *dst++ = '9';
+            }
+        }
+        else
+        {
+            *dst++ = layer;
+        }
+
+        *dst++ = '0' + (color & 7);
+        return dst;
+    }
+
+    if (config.color == ASCII_256COLOR)
+    {
+        n = color;
+    }
+    else if (config.color == ASCII_TRUECOLOR)
+    {
+        n = Exact256(color);
+    }
+
+    if (n >= 0)
+    {
+        *dst++ = layer;
+        *dst++ = '8';
+        *dst++ = ';';
+        *dst++ = '5';
+        *dst++ = ';';
+        dst = PutByte(dst, n);
+        return dst;
+    }
+
+    *dst++ = layer;
+    *dst++ = '8';
+    *dst++ = ';';
+    *dst++ = '2';
+    *dst++ = ';';
+    dst = PutByte(dst, color >> 16);
+    *dst++ = ';';
+    dst = PutByte(dst, (color >> 8) & 0xff);
+    *dst++ = ';';
+    dst = PutByte(dst, color & 0xff);
+
+    return dst;
+}
+
+// Select fg and bg, in a single escape when both change. Pass the
+// current colour for a layer that should stay as it is.
+
+static char *SetColors(char *dst, uint32_t fg, uint32_t bg)
+{
+    if (fg == current_fg && bg == current_bg)
+    {
+        return dst;
+    }
+
+    *dst++ = '\033';
+    *dst++ = '[';
+
+    if (fg != current_fg)
+    {
+        dst = ColorParams(dst, '3', fg);
+        current_fg = fg;
+
+        if (bg != current_bg)
+        {
+            *dst++ = ';';
+        }
+    }
+
+    if (bg != current_bg)
+    {
+        dst = ColorParams(dst, '4', bg);
+        current_bg = bg;
+    }
+
+    *dst++ = 'm';
+
+    return dst;
+}
+
+static char *PutGlyph(char *dst, const glyph_t *glyph)
+{
+    memcpy(dst, glyph->bytes, GLYPH_CELL);
+
+    return dst + glyph->len;
+}
+
+static char *EncodeRampRow(char *dst, const byte *pixel)
+{
+    uint32_t color;
+    int col, run;
+
+    for (col = 0; col < DOOMGENERIC_RESX; col += run, pixel += run)
+    {
+        run = DOOMGENERIC_RESX - col;
+
+        if (config.color != ASCII_MONO)
+        {
+            color = color_lut[*pixel];
+            dst = SetColors(dst, color, current_bg);
+
+            // Extend the run while the colour holds
+            for (run = 1; run < DOOMGENERIC_RESX - col
+                       && color_lut[pixel[run]] == color; ++run)
+                ;
+        }
+
+        dst = encode_glyphs(dst, pixel, run, config.aspect);
+    }
+
+    return dst;
+}
+
+// One character cell of the packed modes, or one pixel of the ramp.
+// fg is NO_COLOR when the glyph may be drawn in any colour; bg is set
+// only for two-colour half blocks (upper half fg, lower half bg).
+
+#define NO_COLOR 0xffffffff
+
+typedef struct
+{
+    const glyph_t *glyph;
+    uint32_t fg;
+    uint32_t bg;
+} cell_t;
+
+// Output row y covers pixel rows 2y and 2y + 1.
+
+static void HalfBlockCells(cell_t *cells, const byte *frame, int y)
+{
+    const byte *top = frame + 2 * y * DOOMGENERIC_RESX;
+    const byte *bottom = top + DOOMGENERIC_RESX;
+    uint32_t t, b;
+    int x;
+
+    for (x = 0; x < DOOMGENERIC_RESX; ++x)
+    {
+        if (config.color == ASCII_MONO)
+        {
+            cells[x].glyph = &half_blocks[DOT(top[x], x, 2 * y)
+                                        | DOT(bottom[x], x, 2 * y + 1) << 1];
+            cells[x].fg = cells[x].bg = NO_COLOR;
+            continue;
+        }
+
+        t = color_lut[top[x]];
+        b = color_lut[bottom[x]];
+
+        if (t == b)
+        {
+            cells[x].glyph = &half_blocks[3];
+            cells[x].fg = t;
+            cells[x].bg = NO_COLOR;
+        }
+        else
+        {
+            cells[x].glyph = &half_blocks[1];
+            cells[x].fg = t;
+            cells[x].bg = b;
+        }
+    }
+}
+
+// Output row y covers pixel rows 4y to 4y + 3, two pixels per cell.
+// In colour the dots take the colour of the brightest pixel.
+
+static void BrailleCells(cell_t *cells, const byte *frame, int y)
+{
+    // Bit for each dot, by row then column.
+    static const byte dot_bits[4][2] =
+    {
+        { 0x01, 0x08 },
+        { 0x02, 0x10 },
+        { 0x04, 0x20 },
+        { 0x40, 0x80 },
+    };
+    const byte *block;
+    byte index, brightest;
+    int x, dx, dy, bits;
+
+    for (x = 0; x < DOOMGENERIC_RESX - 1; x += 2, ++cells)
+    {
+        block = frame + 4 * y * DOOMGENERIC_RESX + x;
+        brightest = block[0];
+        bits = 0;
+
+        for (dy = 0; dy < 4; ++dy)
+        {
+            for (dx = 0; dx < 2; ++dx)
+            {
+                index = block[dy * DOOMGENERIC_RESX + dx];
+
+                if (DOT(index, x + dx, 4 * y + dy))
+                {
+                    bits |= dot_bits[dy][dx];
+                }
+                if (luma_lut[index] > luma_lut[brightest])
+                {
+                    brightest = index;
+                }
+            }
+        }
+
+        // Empty cells are a plain space, in any colour.
+        cells->glyph = bits != 0 ? &braille_lut[bits] : &half_blocks[0];
+        cells->fg = bits != 0 && config.color != ASCII_MONO
+                  ? color_lut[brightest] : NO_COLOR;
+        cells->bg = NO_COLOR;
+    }
+}
+
+static void RampCells(cell_t *cells, const byte *frame, int y)
+{
+    const byte *pixel = frame + y * DOOMGENERIC_RESX;
+    int x;
+
+    for (x = 0; x < DOOMGENERIC_RESX; ++x)
+    {
+        cells[x].glyph = &glyph_lut[pixel[x]];
+        cells[x].fg = config.color != ASCII_MONO
+                    ? color_lut[pixel[x]] : NO_COLOR;
+        cells[x].bg = NO_COLOR;
+    }
+}
+
+// Cells per encoded row, and terminal columns per cell.
+
+static int RowCells(void)
+{
+    return config.cell == ASCII_CELL_BRAILLE ? DOOMGENERIC_RESX / 2
+                                             : DOOMGENERIC_RESX;
+}
+
+static int CellColumns(void)
+{
+    return config.cell == ASCII_CELL_RAMP ? config.aspect : 1;
+}
+
+static void BuildCells(cell_t *cells, const byte *frame, int y)
+{
+    switch (config.cell)
+    {
+        case ASCII_CELL_HALFBLOCK:
+            HalfBlockCells(cells, frame, y);
+            break;
+        case ASCII_CELL_BRAILLE:
+            BrailleCells(cells, frame, y);
+            break;
+        default:
+            RampCells(cells, frame, y);
+            break;
+    }
+}
+
+// Write one cell, reusing the current colours where they already
+// draw it: a full block in the background colour is a space, and a
+// half block with swapped colours is the lower half block.
+
+static char *PutCell(char *dst, const cell_t *cell)
+{
+    int i;
+
+    if (cell->bg != NO_COLOR)
+    {
+        if (cell->fg == current_bg && cell->bg == current_fg)
+        {
+            return PutGlyph(dst, &half_blocks[2]);
+        }
+
+        dst = SetColors(dst, cell->fg, cell->bg);
+        return PutGlyph(dst, cell->glyph);
+    }
+
+    if (cell->fg != NO_COLOR)
+    {
+        if (cell->glyph == &half_blocks[3] && cell->fg == current_bg)
+        {
+            return PutGlyph(dst, &half_blocks[0]);
+        }
+
+        dst = SetColors(dst, cell->fg, current_bg);
+    }
+
+    for (i = 0; i < CellColumns(); ++i)
+    {
+        dst = PutGlyph(dst, cell->glyph);
+    }
+
+    return dst;
+}
+
+static char *EncodeCellRow(char *dst, const byte *frame, int y)
+{
+    static cell_t cells[DOOMGENERIC_RESX];
+    int x;
+
+    BuildCells(cells, frame, y);
+
+    for (x = 0; x < RowCells(); ++x)
+    {
+        dst = PutCell(dst, &cells[x]);
+    }
+
+    return dst;
+}
+
+char *I_ASCIIEncodeRow(char *dst, const byte *frame, int row)
+{
+    switch (config.cell)
+    {
+        case ASCII_CELL_HALFBLOCK:
+        case ASCII_CELL_BRAILLE:
+            return EncodeCellRow(dst, frame, row);
+        default:
+            return EncodeRampRow(dst, frame + row * DOOMGENERIC_RESX);
+    }
+}
+
+char *I_ASCIIEndFrame(char *dst)
+{
+    if (config.color != ASCII_MONO)
+    {
+        *dst++ = '\033';
+        *dst++ = '[';
+        *dst++ = '0';
+        *dst++ = 'm';
+    }
+
+    return dst;
+}
+
+size_t I_ASCIIEncodeFrame(char *dst, const byte *frame)
+{
+    char *buf = dst;
+    int row;
+
+    I_ASCIIBeginFrame();
+
+    for (row = 0; row < I_ASCIIRows(); ++row)
+    {
+        buf = I_ASCIIEncodeRow(buf, frame, row);
+        *buf++ = '\n';
+    }
+
+    buf = I_ASCIIEndFrame(buf);
+
+    return buf - dst;
+}
+
+//
+// Cell diff encoding
+//
+
+// What the terminal shows, one cell_t per cell, rows at RowCells()
+// stride. Only meaningful while screen_valid is set.
+
+static cell_t screen_cells[DOOMGENERIC_RESX * DOOMGENERIC_RESY];
+static boolean screen_valid;
+
+// Serial of the diff that last wrote each cell.
+
+static unsigned int cell_serial[DOOMGENERIC_RESX * DOOMGENERIC_RESY];
+static unsigned int diff_serial;
+
+void I_ASCIIInvalidate(void)
+{
+    screen_valid = false;
+}
+
+// Drops are rare, so rather than test every cell on every diff, the
+// cells of the dropped diff are made to match nothing.
+
+void I_ASCIIDropDiff(void)
+{
+    int i, count = I_ASCIIRows() * RowCells();
+
+    for (i = 0; i < count; ++i)
+    {
+        if (cell_serial[i] == diff_serial)
+        {
+            screen_cells[i].glyph = NULL;
+        }
+    }
+}
+
+static boolean SameCell(const cell_t *a, const cell_t *b)
+{
+    return a->glyph == b->glyph && a->fg == b->fg && a->bg == b->bg;
+}
+
+// Move the cursor to cell x of encoded row y.
+
+static char *MoveCursor(char *dst, int y, int x)
+{
+    *dst++ = '\033';
+    *dst++ = '[';
+    dst = PutNumber(dst, y + 1);
+    *dst++ = ';';
+    dst = PutNumber(dst, x * CellColumns() + 1);
+    *dst++ = 'H';
+
+    return dst;
+}
+
+size_t I_ASCIIDiffSize(void)
+{
+    return I_ASCIIFrameSize()
+         + (size_t) I_ASCIIRows() * RowCells() * CUP_LEN;
+}
+
+size_t I_ASCIIEncodeDiff(char *dst, const byte *frame)
+{
+    static cell_t cells[DOOMGENERIC_RESX];
+    char cup[CUP_LEN];
+    char *buf = dst;
+    char *gap;
+    cell_t *screen;
+    unsigned int *serial;
+    uint32_t fg, bg;
+    int row, x, i, cursor;
+    int count = RowCells();
+
+    I_ASCIIBeginFrame();
+    ++diff_serial;
+
+    for (row = 0; row < I_ASCIIRows(); ++row)
+    {
+        BuildCells(cells, frame, row);
+        screen = screen_cells + row * count;
+        serial = cell_serial + row * count;
+
+        // Cell the cursor is on, or -1 if it is not on this row.
+        cursor = -1;
+
+        for (x = 0; x < count; ++x)
+        {
+            if (screen_valid && SameCell(&cells[x], &screen[x]))
+            {
+                continue;
+            }
+
+            if (cursor != x)
+            {
+                // Try rewriting a short gap of unchanged cells; undo it
+                // if a cursor move would have been shorter.
+                gap = buf;
+                fg = current_fg;
+                bg = current_bg;
+
+                if (cursor >= 0 && x - cursor <= MAX_GAP)
+                {
+                    for (i = cursor; i < x; ++i)
+                    {
+                        buf = PutCell(buf, &cells[i]);
+                    }
+                }
+
+                if (buf == gap || buf - gap > MoveCursor(cup, row, x) - cup)
+                {
+                    buf = MoveCursor(gap, row, x);
+                    current_fg = fg;
+                    current_bg = bg;
+                }
+            }
+
+            buf = PutCell(buf, &cells[x]);
+            screen[x] = cells[x];
+            serial[x] = diff_serial;
+            cursor = x + 1;
+        }
+    }
+
+    screen_valid = true;
+
+    buf = I_ASCIIEndFrame(buf);
+
+    return buf - dst;
+}
@@ -0,0 +1,164 @@
+//
+// Copyright(C) 2022-2024 Wojciech Graj
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Text frame encoder shared by the CMAP_GLYPH backends.
+//
+
+#ifndef __I_ASCII__
+#define __I_ASCII__
+
+#include <stddef.h>
+
+#include "doomtype.h"
+
+typedef enum
+{
+    ASCII_MONO,             // glyphs only
+    ASCII_TRUECOLOR,        // 24-bit SGR foreground on every colour change
+    ASCII_256COLOR,         // nearest xterm-256 colour, 38;5;N
+    ASCII_16COLOR,          // nearest of the 16 ANSI colours, 3N/9N
+} ascii_color_t;
+
+typedef enum
+{
+    ASCII_CELL_RAMP,        // 1 pixel per cell, glyph from the ramp
+    ASCII_CELL_HALFBLOCK,   // 1x2 pixels per cell, upper/lower half blocks
+    ASCII_CELL_BRAILLE,     // 2x4 pixels per cell, U+2800 dot patterns
+} ascii_cell_t;
+
+typedef struct
+{
+    ascii_cell_t cell;
+
+    // Brightness ramp, darkest first, UTF-8. ASCII_CELL_RAMP only.
+    const char *ramp;
+
+    ascii_color_t color;
+
+    // Glyphs written per pixel: 2 where character cells are about
+    // twice as tall as they are wide (terminals), 1 otherwise.
+    // ASCII_CELL_RAMP only; the packed cells are already about square.
+    int aspect;
+} ascii_config_t;
+
+// One glyph of the ramp, pre-encoded as UTF-8. Bytes past len are
+// zero, so an encoder may copy the whole cell and advance by len.
+
+#define GLYPH_CELL 4
+
+typedef struct
+{
+    char bytes[GLYPH_CELL];
+    byte len;
+} glyph_t;
+
+// Rebuilt by I_ASCIIConfigure and I_ASCIISetPalette, so encoding
+// needs a single table load per pixel.
+
+extern glyph_t glyph_lut[256];      // palette index -> ramp glyph
+extern uint32_t color_lut[256];     // palette index -> 0xRRGGBB, or the
+                                    // colour number when quantised
+
+// Select glyph set, colour mode and aspect. Call before encoding;
+// may be called again at any time.
+
+void I_ASCIIConfigure(const ascii_config_t *config);
+
+// Load a new palette as 256 0xRRGGBB entries (called by I_SetPalette).
+
+void I_ASCIISetPalette(const uint32_t *rgb);
+
+// Encoded rows per frame: DOOMGENERIC_RESY divided by the cell height.
+
+int I_ASCIIRows(void);
+
+// Worst case bytes of one encoded row including its newline. Rows
+// laid out at this stride never overlap.
+
+size_t I_ASCIIRowSize(void);
+
+// Worst case bytes written by I_ASCIIEncodeFrame.
+
+size_t I_ASCIIFrameSize(void);
+
+// Encode a whole frame of palette indices, rows separated by
+// newlines. Returns the number of bytes written; there is no
+// terminator.
+
+size_t I_ASCIIEncodeFrame(char *dst, const byte *frame);
+
+// Row-at-a-time interface for backends that keep rows apart. Colour
+// state carries over between rows of the same frame. EncodeRow
+// writes no newline, returns the end of the row and may write up to
+// GLYPH_CELL bytes of padding past it. EndFrame appends whatever
+// resets the colour state and returns the new end.
+
+void I_ASCIIBeginFrame(void);
+char *I_ASCIIEncodeRow(char *dst, const byte *frame, int row);
+char *I_ASCIIEndFrame(char *dst);
+
+// Encode only the cells that differ from the last frame encoded by
+// I_ASCIIEncodeDiff, each run of changed cells preceded by a cursor
+// position escape (rows and columns from 1 at the top left of the
+// frame). Returns the number of bytes written, 0 if nothing changed
+// and the frame carries no colour state. The first frame after
+// I_ASCIIInvalidate, I_ASCIIConfigure or I_ASCIISetPalette is
+// written whole.
+
+size_t I_ASCIIEncodeDiff(char *dst, const byte *frame);
+
+// Worst case bytes written by I_ASCIIEncodeDiff.
+
+size_t I_ASCIIDiffSize(void);
+
+// Forget what the terminal shows, e.g. after clearing it.
+
+void I_ASCIIInvalidate(void);
+
+// The last frame from I_ASCIIEncodeDiff never reached the terminal;
+// the next diff writes its cells again. For writers that drop stale
+// frames rather than queue them.
+
+void I_ASCIIDropDiff(void);
+
+// A glyph kernel translates count palette indices from src into
+// glyph_lut glyphs, writing each glyph repeat (1 or 2) times. It
+// returns the new end of dst and may write up to GLYPH_CELL bytes of
+// padding past it.
+
+typedef char *(*glyph_kernel_t)(char *dst, const byte *src, int count,
+                                int repeat);
+
+typedef struct
+{
+    const char *name;
+    glyph_kernel_t encode;
+
+    // Only correct when every glyph in the ramp is a single byte.
+    boolean narrow;
+
+    // Nonzero if the running CPU can execute this kernel.
+    int (*supported)(void);
+} glyph_kernel_info_t;
+
+// Every kernel built into this binary, terminated by a NULL name.
+
+extern const glyph_kernel_info_t glyph_kernels[];
+
+// Fastest supported kernel. narrow is true for single-byte ramps.
+
+glyph_kernel_t I_GlyphKernel(boolean narrow);
+
+#endif
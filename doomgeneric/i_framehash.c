@@ -0,0 +1,528 @@
+//
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Frame checksums for demo playback.
+//
+//      Each stage is hashed in tiles, so a difference can be traced
+//      to a region of the frame: images in an 8x8 grid, byte streams
+//      in 64 runs. One record is kept per game tic, from the last
+//      frame presented at it; wipes present several frames at a tic
+//      and how many depends on the clock, but the last is complete.
+//      The file has one line per stage:
+//
+//          <tic> <stage> <width>x<height> <tile hash> ...
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "d_loop.h"
+#include "i_framehash.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+
+#define TILES_X 8
+#define TILES_Y 8
+#define TILES (TILES_X * TILES_Y)
+
+#define FNV32_BASIS 0x811c9dc5u
+#define FNV32_PRIME 0x01000193u
+
+typedef struct
+{
+    int width;                  // bytes for a byte stream
+    int height;                 // 1 for a byte stream
+    uint32_t tiles[TILES];
+} stagehash_t;
+
+typedef struct
+{
+    int tic;
+    unsigned int stages;        // bit per framehashphase_t hashed
+    stagehash_t stage[NUMFRAMEHASHPHASES];
+} framerecord_t;
+
+static const char *stage_names[NUMFRAMEHASHPHASES] =
+{
+    "video",
+    "rgba",
+    "ascii",
+};
+
+static boolean framehash_active;
+static boolean framehash_failed;
+
+static framerecord_t current;
+static unsigned int num_records;
+
+static FILE *hash_file;
+static char *hash_filename;
+
+static FILE *check_file;
+static char *check_filename;
+static char check_line[1024];
+static boolean check_line_pending;
+
+static uint32_t HashBytes(uint32_t h, const byte *data, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; ++i)
+    {
+        h = (h ^ data[i]) * FNV32_PRIME;
+    }
+
+    return h;
+}
+
+static void WriteRecord(const framerecord_t *rec)
+{
+    int phase, i;
+
+    for (phase = 0; phase < NUMFRAMEHASHPHASES; ++phase)
+    {
+        const stagehash_t *stage = &rec->stage[phase];
+
+        if ((rec->stages & (1 << phase)) == 0)
+        {
+            continue;
+        }
+
+        fprintf(hash_file, "%d %s %dx%d", rec->tic, stage_names[phase],
+                stage->width, stage->height);
+
+        for (i = 0; i < TILES; ++i)
+        {
+            fprintf(hash_file, " %08x", stage->tiles[i]);
+        }
+
+        fprintf(hash_file, "\n");
+    }
+}
+
+static boolean ParseLine(const char *line, int *tic, int *phase,
+                         stagehash_t *stage)
+{
+    char name[16];
+    char *p;
+    int n, i;
+
+    if (sscanf(line, "%d %15s %dx%d%n", tic, name,
+               &stage->width, &stage->height, &n) != 4)
+    {
+        return false;
+    }
+
+    for (*phase = 0; *phase < NUMFRAMEHASHPHASES; ++*phase)
+    {
+        if (!strcmp(name, stage_names[*phase]))
+        {
+            break;
+        }
+    }
+
+    if (*phase == NUMFRAMEHASHPHASES)
+    {
+        return false;
+    }
+
+    p = (char *) line + n;
+
+    for (i = 0; i < TILES; ++i)
+    {
+        char *end;
+
+        stage->tiles[i] = (uint32_t) strtoul(p, &end, 16);
+
+        if (end == p)
+        {
+            return false;
+        }
+
+        p = end;
+    }
+
+    return true;
+}
+
+// Reads the lines of the next tic of the -framecheck file; false at
+// its end.
+
+static boolean ReadRecord(framerecord_t *rec)
+{
+    stagehash_t stage;
+    int tic, phase = 0;
+
+    memset(rec, 0, sizeof(*rec));
+
+    for (;;)
+    {
+        if (!check_line_pending
+         && fgets(check_line, sizeof(check_line), check_file) == NULL)
+        {
+            return rec->stages != 0;
+        }
+
+        check_line_pending = false;
+
+        if (check_line[0] == '#')
+        {
+            continue;
+        }
+
+        if (!ParseLine(check_line, &tic, &phase, &stage))
+        {
+            I_Error("framehash: bad line in %s: %s",
+                    check_filename, check_line);
+        }
+
+        if (rec->stages != 0 && tic != rec->tic)
+        {
+            check_line_pending = true;
+            return true;
+        }
+
+        rec->tic = tic;
+        rec->stages |= 1 << phase;
+        rec->stage[phase] = stage;
+    }
+}
+
+// Describes where two hashes of a stage differ: the bounding box of
+// the tiles that differ, in pixels, or a range of bytes.
+
+static void DescribeRegion(const stagehash_t *a, const stagehash_t *b,
+                           char *buf, size_t len)
+{
+    int x0 = TILES_X, y0 = TILES_Y, x1 = -1, y1 = -1;
+    int first = -1, last = -1;
+    int i;
+
+    for (i = 0; i < TILES; ++i)
+    {
+        if (a->tiles[i] != b->tiles[i])
+        {
+            int tx = i % TILES_X, ty = i / TILES_X;
+
+            if (first < 0) first = i;
+            last = i;
+
+            if (tx < x0) x0 = tx;
+            if (tx > x1) x1 = tx;
+            if (ty < y0) y0 = ty;
+            if (ty > y1) y1 = ty;
+        }
+    }
+
+    if (a->height == 1)
+    {
+        M_snprintf(buf, len, "bytes %d-%d of %d",
+                   (int) ((long) first * a->width / TILES),
+                   (int) ((long) (last + 1) * a->width / TILES) - 1,
+                   a->width);
+    }
+    else
+    {
+        M_snprintf(buf, len, "pixels (%d,%d)-(%d,%d)",
+                   x0 * a->width / TILES_X, y0 * a->height / TILES_Y,
+                   (x1 + 1) * a->width / TILES_X - 1,
+                   (y1 + 1) * a->height / TILES_Y - 1);
+    }
+}
+
+// Compares a record with the next one in the -framecheck file. On a
+// difference, describes the first one in msg and returns false.
+
+static boolean CheckRecord(const framerecord_t *rec, char *msg, size_t len)
+{
+    framerecord_t golden;
+    char region[64];
+    int phase;
+
+    if (!ReadRecord(&golden))
+    {
+        M_snprintf(msg, len, "framehash: %s ends before frame %u (tic %d)",
+                   check_filename, num_records, rec->tic);
+        return false;
+    }
+
+    if (golden.tic != rec->tic)
+    {
+        M_snprintf(msg, len, "framehash: frame %u is tic %d, but tic %d "
+                   "in %s; frames are only repeatable with -timedemo",
+                   num_records, rec->tic, golden.tic, check_filename);
+        return false;
+    }
+
+    for (phase = 0; phase < NUMFRAMEHASHPHASES; ++phase)
+    {
+        const stagehash_t *a = &rec->stage[phase];
+        const stagehash_t *b = &golden.stage[phase];
+
+        // Builds need not produce the same stages: compare those
+        // both have.
+        if ((rec->stages & golden.stages & (1 << phase)) == 0)
+        {
+            continue;
+        }
+
+        if (a->width != b->width || a->height != b->height)
+        {
+            M_snprintf(msg, len, "framehash: frame %u (tic %d): %s is "
+                       "%dx%d, but %dx%d in %s", num_records, rec->tic,
+                       stage_names[phase], a->width, a->height,
+                       b->width, b->height, check_filename);
+            return false;
+        }
+
+        if (memcmp(a->tiles, b->tiles, sizeof(a->tiles)) != 0)
+        {
+            DescribeRegion(a, b, region, sizeof(region));
+            M_snprintf(msg, len, "framehash: frame %u (tic %d) differs "
+                       "from %s in %s, %s", num_records, rec->tic,
+                       check_filename, stage_names[phase], region);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Writes and checks the record of the tic being presented; false if
+// it differs from the -framecheck file.
+
+static boolean FinishRecord(char *msg, size_t len)
+{
+    boolean ok = true;
+
+    if (current.stages == 0)
+    {
+        return true;
+    }
+
+    if (hash_file != NULL)
+    {
+        WriteRecord(&current);
+    }
+
+    if (check_file != NULL && !framehash_failed)
+    {
+        ok = CheckRecord(&current, msg, len);
+        framehash_failed = !ok;
+    }
+
+    ++num_records;
+    memset(&current, 0, sizeof(current));
+
+    return ok;
+}
+
+static stagehash_t *BeginStage(framehashphase_t phase)
+{
+    char msg[256];
+
+    if (!I_FrameHashing())
+    {
+        return NULL;
+    }
+
+    if (current.stages != 0 && current.tic != gametic)
+    {
+        if (!FinishRecord(msg, sizeof(msg)))
+        {
+            I_Error("%s", msg);
+        }
+    }
+
+    current.tic = gametic;
+    current.stages |= 1 << phase;
+
+    return &current.stage[phase];
+}
+
+boolean I_FrameHashing(void)
+{
+    return framehash_active && demoplayback;
+}
+
+boolean I_FrameHashFailed(void)
+{
+    return framehash_failed;
+}
+
+void I_FrameHashImage(framehashphase_t phase, const void *pixels,
+                      int width, int height, int bytes_per_pixel)
+{
+    stagehash_t *stage = BeginStage(phase);
+    const byte *row;
+    int tx, ty, y;
+
+    if (stage == NULL)
+    {
+        return;
+    }
+
+    stage->width = width;
+    stage->height = height;
+
+    for (ty = 0; ty < TILES_Y; ++ty)
+    {
+        uint32_t *tiles = &stage->tiles[ty * TILES_X];
+
+        for (tx = 0; tx < TILES_X; ++tx)
+        {
+            tiles[tx] = FNV32_BASIS;
+        }
+
+        for (y = ty * height / TILES_Y; y < (ty + 1) * height / TILES_Y; ++y)
+        {
+            row = (const byte *) pixels + (size_t) y * width * bytes_per_pixel;
+
+            for (tx = 0; tx < TILES_X; ++tx)
+            {
+                int x0 = tx * width / TILES_X;
+                int x1 = (tx + 1) * width / TILES_X;
+
+                tiles[tx] = HashBytes(tiles[tx], row + x0 * bytes_per_pixel,
+                                      (x1 - x0) * bytes_per_pixel);
+            }
+        }
+    }
+}
+
+void I_FrameHashBytes(framehashphase_t phase, const void *data, size_t len)
+{
+    stagehash_t *stage = BeginStage(phase);
+    int i;
+
+    if (stage == NULL)
+    {
+        return;
+    }
+
+    stage->width = (int) len;
+    stage->height = 1;
+
+    for (i = 0; i < TILES; ++i)
+    {
+        size_t start = i * len / TILES;
+        size_t end = (i + 1) * len / TILES;
+
+        stage->tiles[i] = HashBytes(FNV32_BASIS, (const byte *) data + start,
+                                    end - start);
+    }
+}
+
+static void I_FrameHashShutdown(void)
+{
+    char msg[256];
+
+    if (!framehash_active)
+    {
+        return;
+    }
+
+    framehash_active = false;
+
+    // The last tic presented has no successor to finish it.
+    if (!FinishRecord(msg, sizeof(msg)))
+    {
+        fprintf(stderr, "%s\n", msg);
+    }
+
+    if (hash_file != NULL)
+    {
+        fclose(hash_file);
+        fprintf(stderr, "framehash: wrote %u frames to %s\n",
+                num_records, hash_filename);
+    }
+
+    if (check_file != NULL)
+    {
+        if (!framehash_failed)
+        {
+            fprintf(stderr, "framehash: %u frames match %s\n",
+                    num_records, check_filename);
+
+            if (ReadRecord(&current))
+            {
+                fprintf(stderr, "framehash: %s has frames past the end "
+                        "of this run\n", check_filename);
+            }
+        }
+
+        fclose(check_file);
+    }
+}
+
+void I_FrameHashInit(void)
+{
+    int p;
+
+    //!
+    // @arg <file>
+    // @category video
+    //
+    // During demo playback, write hashes of each frame to file: the
+    // rendered frame, the RGBA frame buffer and the text encoder
+    // output, whichever the build produces. Use with -timedemo.
+    //
+
+    p = M_CheckParmWithArgs("-framehash", 1);
+
+    if (p > 0)
+    {
+        hash_filename = myargv[p + 1];
+        hash_file = fopen(hash_filename, "w");
+
+        if (hash_file == NULL)
+        {
+            I_Error("framehash: cannot write %s", hash_filename);
+        }
+
+        fprintf(hash_file, "# tic stage size tile hashes\n");
+    }
+
+    //!
+    // @arg <file>
+    // @category video
+    //
+    // During demo playback, compare each frame with the hashes in a
+    // file written by -framehash, and stop with an error at the
+    // first frame, stage and region that differ.
+    //
+
+    p = M_CheckParmWithArgs("-framecheck", 1);
+
+    if (p > 0)
+    {
+        check_filename = myargv[p + 1];
+        check_file = fopen(check_filename, "r");
+
+        if (check_file == NULL)
+        {
+            I_Error("framehash: cannot read %s", check_filename);
+        }
+    }
+
+    framehash_active = hash_file != NULL || check_file != NULL;
+
+    if (framehash_active)
+    {
+        I_AtExit(I_FrameHashShutdown, true);
+    }
+}
@@ -0,0 +1,52 @@
+//
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Frame checksums for demo playback. -framehash <file> writes
+//      hashes of every stage of each presented frame; -framecheck
+//      <file> compares a run against such a file and stops at the
+//      first frame, stage and region that differ.
+//
+
+#ifndef __I_FRAMEHASH__
+#define __I_FRAMEHASH__
+
+#include <stddef.h>
+
+#include "doomtype.h"
+
+// Stages of a frame, in the order they are produced.
+
+typedef enum
+{
+    FRAMEHASH_VIDEO,        // I_VideoBuffer, palette indices
+    FRAMEHASH_RGBA,         // DG_ScreenBuffer after cmap_to_fb
+    FRAMEHASH_ASCII,        // text encoder output
+    NUMFRAMEHASHPHASES
+} framehashphase_t;
+
+void I_FrameHashInit(void);
+
+// True while frames are being hashed, so backends can skip
+// producing output only the hash needs.
+boolean I_FrameHashing(void);
+
+void I_FrameHashImage(framehashphase_t phase, const void *pixels,
+                      int width, int height, int bytes_per_pixel);
+void I_FrameHashBytes(framehashphase_t phase, const void *data,
+                      size_t len);
+
+// True once -framecheck has found a difference.
+boolean I_FrameHashFailed(void);
+
+#endif
@@ -0,0 +1,354 @@
+//
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Per-phase frame profiler.
+//
+
+#include "i_profile.h"
+
+#ifdef PROFILE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "doomtype.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Frames kept for the dump and the percentiles, and single timed
+// spans kept for the trace. Older ones are overwritten.
+
+#define PROFILE_FRAMES 8192
+#define PROFILE_EVENTS 65536
+
+typedef struct
+{
+    uint64_t start_ns;
+    uint32_t phase_ns[NUMPROFPHASES];   // summed over the frame
+} profframe_t;
+
+typedef struct
+{
+    uint64_t start_ns;
+    uint32_t dur_ns;
+    uint32_t phase;
+} profevent_t;
+
+static const char *phase_names[NUMPROFPHASES] =
+{
+    "P_Ticker",
+    "R_RenderBSPNode",
+    "R_DrawPlanes",
+    "R_DrawMasked",
+    "ST_Drawer",
+    "M_Drawer",
+    "I_FinishUpdate",
+    "DG_DrawFrame",
+};
+
+static profframe_t frames[PROFILE_FRAMES];
+static profevent_t events[PROFILE_EVENTS];
+
+// Frames and events recorded so far; the current frame is
+// frames[num_frames % PROFILE_FRAMES].
+static unsigned int num_frames;
+static unsigned int num_events;
+
+static uint64_t begin_ns[NUMPROFPHASES];
+static uint64_t base_ns;
+static char *profile_file;
+
+static uint64_t ProfileNs(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+
+    if (freq.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&freq);
+    }
+
+    QueryPerformanceCounter(&count);
+
+    return (uint64_t) (count.QuadPart * (1e9 / freq.QuadPart));
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+void I_ProfileBegin(profphase_t phase)
+{
+    begin_ns[phase] = ProfileNs();
+}
+
+void I_ProfileEnd(profphase_t phase)
+{
+    uint64_t now = ProfileNs();
+    uint32_t dur = (uint32_t) (now - begin_ns[phase]);
+    profevent_t *event = &events[num_events++ % PROFILE_EVENTS];
+
+    frames[num_frames % PROFILE_FRAMES].phase_ns[phase] += dur;
+
+    event->start_ns = begin_ns[phase] - base_ns;
+    event->dur_ns = dur;
+    event->phase = phase;
+}
+
+void I_ProfileFrame(void)
+{
+    profframe_t *frame = &frames[++num_frames % PROFILE_FRAMES];
+
+    memset(frame, 0, sizeof(*frame));
+    frame->start_ns = ProfileNs() - base_ns;
+}
+
+// Oldest frame still in the ring. The ring holds the frames up to
+// num_frames, the one in progress, so once it has wrapped the oldest
+// is PROFILE_FRAMES - 1 before that.
+
+static unsigned int FirstFrame(void)
+{
+    return num_frames >= PROFILE_FRAMES ? num_frames - PROFILE_FRAMES + 1 : 0;
+}
+
+static profframe_t *Frame(unsigned int n)
+{
+    return &frames[n % PROFILE_FRAMES];
+}
+
+static int CompareU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted array.
+
+static double Percentile(const uint32_t *sorted, unsigned int count, int p)
+{
+    unsigned int rank = (count * p + 99) / 100;
+
+    return sorted[rank > 0 ? rank - 1 : 0] / 1e6;
+}
+
+static void PrintSummaryRow(const char *name, uint32_t *values,
+                            unsigned int count)
+{
+    uint64_t total = 0;
+    unsigned int i;
+
+    for (i = 0; i < count; ++i)
+    {
+        total += values[i];
+    }
+
+    qsort(values, count, sizeof(*values), CompareU32);
+
+    fprintf(stderr, "%-16s %9.3f %9.3f %9.3f %9.3f %9.3f\n", name,
+            total / 1e6 / count,
+            Percentile(values, count, 50), Percentile(values, count, 95),
+            Percentile(values, count, 99), values[count - 1] / 1e6);
+}
+
+static void PrintSummary(void)
+{
+    unsigned int first = FirstFrame();
+    unsigned int count = num_frames - first;
+    uint32_t *values;
+    unsigned int n;
+    int phase;
+
+    // The last complete frame has no successor to measure it by.
+    if (count < 2)
+    {
+        return;
+    }
+
+    values = malloc(count * sizeof(*values));
+
+    if (values == NULL)
+    {
+        return;
+    }
+
+    fprintf(stderr, "profile: %u frames, ms per frame\n", count - 1);
+    fprintf(stderr, "%-16s %9s %9s %9s %9s %9s\n",
+            "phase", "mean", "p50", "p95", "p99", "max");
+
+    for (n = first; n < num_frames - 1; ++n)
+    {
+        values[n - first] =
+            (uint32_t) (Frame(n + 1)->start_ns - Frame(n)->start_ns);
+    }
+
+    PrintSummaryRow("frame", values, count - 1);
+
+    for (phase = 0; phase < NUMPROFPHASES; ++phase)
+    {
+        for (n = first; n < num_frames - 1; ++n)
+        {
+            values[n - first] = Frame(n)->phase_ns[phase];
+        }
+
+        PrintSummaryRow(phase_names[phase], values, count - 1);
+    }
+
+    free(values);
+}
+
+static void WriteCSV(FILE *f)
+{
+    unsigned int n;
+    int phase;
+
+    fprintf(f, "frame,start_ms");
+
+    for (phase = 0; phase < NUMPROFPHASES; ++phase)
+    {
+        fprintf(f, ",%s_ms", phase_names[phase]);
+    }
+
+    fprintf(f, "\n");
+
+    for (n = FirstFrame(); n < num_frames; ++n)
+    {
+        fprintf(f, "%u,%.3f", n, Frame(n)->start_ns / 1e6);
+
+        for (phase = 0; phase < NUMPROFPHASES; ++phase)
+        {
+            fprintf(f, ",%.3f", Frame(n)->phase_ns[phase] / 1e6);
+        }
+
+        fprintf(f, "\n");
+    }
+}
+
+// Chrome trace_event format, for chrome://tracing or Perfetto: frames
+// on one track, timed phases on another.
+
+static void WriteTrace(FILE *f)
+{
+    unsigned int first = FirstFrame();
+    unsigned int n;
+    const char *sep = "";
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (n = first; n + 1 < num_frames; ++n)
+    {
+        fprintf(f, "%s{\"name\":\"frame %u\",\"ph\":\"X\",\"pid\":1,"
+                   "\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                sep, n, Frame(n)->start_ns / 1e3,
+                (Frame(n + 1)->start_ns - Frame(n)->start_ns) / 1e3);
+        sep = ",\n";
+    }
+
+    n = num_events > PROFILE_EVENTS ? num_events - PROFILE_EVENTS : 0;
+
+    for (; n < num_events; ++n)
+    {
+        const profevent_t *event = &events[n % PROFILE_EVENTS];
+
+        // Only spans within the frames kept.
+        if (first > 0 && event->start_ns < Frame(first)->start_ns)
+        {
+            continue;
+        }
+
+        fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,"
+                   "\"tid\":2,\"ts\":%.3f,\"dur\":%.3f}",
+                sep, phase_names[event->phase],
+                event->start_ns / 1e3, event->dur_ns / 1e3);
+        sep = ",\n";
+    }
+
+    fprintf(f, "\n]}\n");
+}
+
+static void I_ProfileShutdown(void)
+{
+    FILE *f;
+
+    PrintSummary();
+
+    if (profile_file == NULL)
+    {
+        return;
+    }
+
+    f = fopen(profile_file, "w");
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "profile: cannot write %s\n", profile_file);
+        return;
+    }
+
+    if (M_StringEndsWith(profile_file, ".json"))
+    {
+        WriteTrace(f);
+    }
+    else
+    {
+        WriteCSV(f);
+    }
+
+    fclose(f);
+
+    fprintf(stderr, "profile: wrote %s\n", profile_file);
+}
+
+void I_ProfileInit(void)
+{
+    int p;
+
+    //!
+    // @arg <file>
+    //
+    // In builds with PROFILE defined, write per-phase frame times to
+    // file at exit: Chrome trace_event JSON if it ends in .json,
+    // otherwise CSV.
+    //
+
+    p = M_CheckParmWithArgs("-profile", 1);
+
+    if (p > 0)
+    {
+        profile_file = myargv[p + 1];
+    }
+
+    base_ns = ProfileNs();
+    num_frames = 0;
+    num_events = 0;
+    memset(&frames[0], 0, sizeof(frames[0]));
+
+    I_AtExit(I_ProfileShutdown, true);
+}
+
+#endif // PROFILE
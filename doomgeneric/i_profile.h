@@ -0,0 +1,58 @@
+//
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Per-phase frame profiler. Compiled out unless PROFILE is
+//      defined; then every phase of every frame is timed, p50/p95/p99
+//      per phase print at exit and -profile <file> dumps the recent
+//      frames as CSV, or as Chrome trace_event JSON for a .json file.
+//
+
+#ifndef __I_PROFILE__
+#define __I_PROFILE__
+
+typedef enum
+{
+    PROF_TICKER,            // P_Ticker
+    PROF_BSP,               // R_RenderBSPNode
+    PROF_PLANES,            // R_DrawPlanes
+    PROF_MASKED,            // R_DrawMasked
+    PROF_STATUSBAR,         // ST_Drawer
+    PROF_MENU,              // M_Drawer
+    PROF_FINISHUPDATE,      // I_FinishUpdate
+    PROF_DRAWFRAME,         // DG_DrawFrame, within I_FinishUpdate
+    NUMPROFPHASES
+} profphase_t;
+
+#ifdef PROFILE
+
+void I_ProfileInit(void);
+void I_ProfileBegin(profphase_t phase);
+void I_ProfileEnd(profphase_t phase);
+void I_ProfileFrame(void);
+
+#define PROFILE_INIT()          I_ProfileInit()
+#define PROFILE_BEGIN(phase)    I_ProfileBegin(phase)
+#define PROFILE_END(phase)      I_ProfileEnd(phase)
+#define PROFILE_FRAME()         I_ProfileFrame()
+
+#else
+
+#define PROFILE_INIT()
+#define PROFILE_BEGIN(phase)
+#define PROFILE_END(phase)
+#define PROFILE_FRAME()
+
+#endif
+
+#endif
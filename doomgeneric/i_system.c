@@ -239,6 +239,8 @@ void I_BindVariables(void)
 }
 */
 
+static boolean already_quitting = false;
+
 //
 // I_Quit
 //
@@ -247,6 +249,15 @@ void I_Quit (void)
 {
     atexit_listentry_t *entry;
 
+    // An exit function run by I_Error can end in I_Quit (the demo
+    // status check does, for -playdemo); the error is still what
+    // ends the program, so only the error's exit functions run.
+
+    if (already_quitting)
+    {
+        return;
+    }
+
     // Run through all exit functions
  
     entry = exit_funcs; 
@@ -354,8 +365,6 @@ static int ZenityErrorBox(char *message)
 // I_Error
 //
 
-static boolean already_quitting = false;
-
 void I_Error (char *error, ...)
 {
     char msgbuf[512];
@@ -71,6 +71,21 @@ int I_GetTimeMS(void)
     return ticks - basetime;
 }
 
+int I_GetLiveTimeMS(void)
+{
+    uint32_t ticks;
+
+    if (DG_GetLiveTicksMs == NULL)
+        return I_GetTimeMS();
+
+    ticks = DG_GetLiveTicksMs();
+
+    if (basetime == 0)
+        basetime = ticks;
+
+    return ticks - basetime;
+}
+
 // Sleep for a specified number of ms
 
 void I_Sleep(int ms)
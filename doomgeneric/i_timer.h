@@ -29,6 +29,9 @@ int I_GetTime (void);
 // returns current time in ms
 int I_GetTimeMS (void);
 
+// I_GetTimeMS, but current at every call, for measuring costs
+int I_GetLiveTimeMS (void);
+
 // Pause for a specified number of ms
 void I_Sleep(int ms);
 
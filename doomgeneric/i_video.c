@@ -31,8 +31,12 @@ static const char
 #include "d_event.h"
 #include "d_main.h"
 #include "i_video.h"
+#include "i_ascii.h"
+#include "i_framehash.h"
+#include "i_profile.h"
 #include "z_zone.h"
 #include "i_scale.h"
+#include "i_system.h"
 
 #include "tables.h"
 #include "doomkeys.h"
@@ -41,6 +45,7 @@ static const char
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <fcntl.h>
 
@@ -87,6 +92,14 @@ static struct color colors[256];
 
 #endif // CMAP256
 
+#ifdef CMAP_GLYPH
+
+#if DOOMGENERIC_RESX != SCREENWIDTH || DOOMGENERIC_RESY != SCREENHEIGHT
+#error "CMAP_GLYPH encodes I_VideoBuffer directly; DOOMGENERIC_RESX/RESY must match the render resolution"
+#endif
+
+#endif // CMAP_GLYPH
+
 void I_GetEvent(void);
 
 // The screen buffer; this is modified to draw things to the screen
@@ -156,14 +169,8 @@ void cmap_to_fb(uint8_t *out, uint8_t *in, int in_pixels)
     struct color c;
     uint32_t pix;
     uint16_t r, g, b;
-    
-    // RB ADDED: Determine step size based on scaling
-    int step = (fb_scaling == 0) ? 2 : 1;  // Skip every other pixel if half-scaling
-    
-    // RB ADDED: Adjust number of pixels to process if half-scaling
-    int pixels_to_process = (fb_scaling == 0) ? in_pixels/2 : in_pixels;
-    
-    for (i = 0; i < pixels_to_process; i++)
+
+    for (i = 0; i < in_pixels; i++)
     {
         c = colors[*in]; /* R:8 G:8 B:8 format! */
         r = (uint16_t)(c.r >> (8 - s_Fb.red.length));
@@ -173,9 +180,7 @@ void cmap_to_fb(uint8_t *out, uint8_t *in, int in_pixels)
         pix |= g << s_Fb.green.offset;
         pix |= b << s_Fb.blue.offset;
 
-        // Only scale up if not in half-scale mode
-        int scale = (fb_scaling == 0) ? 1 : fb_scaling;
-        for (k = 0; k < scale; k++)
+        for (k = 0; k < fb_scaling; k++)
         {
             for (j = 0; j < s_Fb.bits_per_pixel / 8; j++)
             {
@@ -184,7 +189,7 @@ void cmap_to_fb(uint8_t *out, uint8_t *in, int in_pixels)
             }
         }
         
-        in += step;  // Skip a pixel if half-scaling
+        in++;
     }
 }
 
@@ -193,8 +198,8 @@ void I_InitGraphics(void)
     int i;
 
     memset(&s_Fb, 0, sizeof(struct FB_ScreenInfo));
-    s_Fb.xres = SCREENWIDTH;
-    s_Fb.yres = SCREENHEIGHT;
+    s_Fb.xres = DOOMGENERIC_RESX;
+    s_Fb.yres = DOOMGENERIC_RESY;
     s_Fb.xres_virtual = s_Fb.xres;
     s_Fb.yres_virtual = s_Fb.yres;
 
@@ -236,15 +241,18 @@ void I_InitGraphics(void)
     else
     {
         fb_scaling = s_Fb.xres / SCREENWIDTH;
-#ifdef HALF_SCALE 
-        // RB added half-scale
-        fb_scaling = 0;
-        printf("I_InitGraphics: HALF SCALE (RB)");
-#else
         if (s_Fb.yres / SCREENHEIGHT < fb_scaling)
             fb_scaling = s_Fb.yres / SCREENHEIGHT;
         printf("I_InitGraphics: Auto-scaling factor: %d\n", fb_scaling);
-#endif
+    }
+
+    // HALF_SCALE builds render natively at the output resolution,
+    // so there is nothing left to decimate here.
+    if (fb_scaling < 1)
+    {
+        I_Error("I_InitGraphics: %dx%d output is smaller than the %dx%d render "
+                "resolution; build with LOWRES", s_Fb.xres, s_Fb.yres,
+                SCREENWIDTH, SCREENHEIGHT);
     }
 
     /* Allocate screen to draw to */
@@ -252,6 +260,8 @@ void I_InitGraphics(void)
 
     screenvisible = true;
 
+    I_FrameHashInit();
+
     extern void I_InitInput(void);
     I_InitInput();
 }
@@ -286,6 +296,17 @@ void I_FinishUpdate(void)
     int x_offset, y_offset, x_offset_end;
     unsigned char* line_in, * line_out;
 
+    I_FrameHashImage(FRAMEHASH_VIDEO, I_VideoBuffer, SCREENWIDTH, SCREENHEIGHT, 1);
+
+#ifdef CMAP_GLYPH
+    /* Text backends read I_VideoBuffer through glyph_lut; there is
+       no RGBA frame buffer to fill. */
+    PROFILE_BEGIN(PROF_DRAWFRAME);
+    DG_DrawFrame();
+    PROFILE_END(PROF_DRAWFRAME);
+    return;
+#endif
+
     /* Offsets in case FB is bigger than DOOM */
     /* 600 = s_Fb heigt, 200 screenheight */
     /* 600 = s_Fb heigt, 200 screenheight */
@@ -293,20 +314,14 @@ void I_FinishUpdate(void)
 
     /* Calculate scaling and offset values for centering the game screen
        in a potentially larger frame buffer */
-    int h = fb_scaling == 0 ? SCREENHEIGHT / 2 : (SCREENHEIGHT * fb_scaling);   // Output height (half or scaled)
-    int w = fb_scaling == 0 ? SCREENWIDTH / 2 : (SCREENWIDTH * fb_scaling);     // Output width (half or scaled)
+    int h = SCREENHEIGHT * fb_scaling;   // Output height
+    int w = SCREENWIDTH * fb_scaling;    // Output width
     
     /* Calculate vertical and horizontal offsets to center the game screen
        Takes into account the bits per pixel of the frame buffer */
-    y_offset = fb_scaling == 0 ? 
-        0 : 
-        (((s_Fb.yres - h) * s_Fb.bits_per_pixel / 8)) / 2;  // Center vertically
-    x_offset = fb_scaling == 0 ? 
-        0 : 
-        (((s_Fb.xres - w) * s_Fb.bits_per_pixel / 8)) / 2;  // Center horizontally
-    x_offset_end = fb_scaling == 0 ?
-        0 : 
-        ((s_Fb.xres - w) * s_Fb.bits_per_pixel / 8) - x_offset; // Remaining padding after each line
+    y_offset = (((s_Fb.yres - h) * s_Fb.bits_per_pixel / 8)) / 2;  // Center vertically
+    x_offset = (((s_Fb.xres - w) * s_Fb.bits_per_pixel / 8)) / 2;  // Center horizontally
+    x_offset_end = ((s_Fb.xres - w) * s_Fb.bits_per_pixel / 8) - x_offset; // Remaining padding after each line
 
     /* Set up pointers for the copy operation */
     line_in = (unsigned char*)I_VideoBuffer;     // Source: DOOM's render buffer
@@ -314,70 +329,50 @@ void I_FinishUpdate(void)
 
     /* Main drawing loop - processes each line of the screen */
     y = SCREENHEIGHT;
-    int scale = fb_scaling > 0 ? fb_scaling : 1;  // Determine scaling factor (minimum 1)
     while (y--)
     {
-        // RB added if for half scale
-        if (fb_scaling == 0)
+        /* For each input line, we may need to write multiple output lines when scaling */
+        for (int i = 0; i < fb_scaling; i++)
         {
-            // Only process every other line for half-scaling
-            if (y % 2 == 0)
-            {
-                line_out += x_offset;
-#ifdef CMAP256
-                // Need to implement half-scaling horizontally
-                for (int j = 0; j < SCREENWIDTH; j += 2)
-                {
-                    line_out[j / 2] = line_in[j];  // Take every other pixel
-                }
-#else
-                // Need to modify cmap_to_fb to handle half-scaling
-                cmap_to_fb((void*)line_out, (void*)line_in, SCREENWIDTH);
-#endif
-                line_out += (w * (s_Fb.bits_per_pixel / 8)) + x_offset_end;
-            }
-        }
-        else
-        {
-            /* For each input line, we may need to write multiple output lines when scaling */
-            for (int i = 0; i < scale; i++)
-            {
-                line_out += x_offset;  // Skip to the centered position
+            line_out += x_offset;  // Skip to the centered position
 
 #ifdef CMAP256
 /* 256-color palette mode */
-                if (fb_scaling == 1)
-                {
-                    /* Direct 1:1 copy for unscaled output */
-                    memcpy(line_out, line_in, SCREENWIDTH);
-                }
-                else
+            if (fb_scaling == 1)
+            {
+                /* Direct 1:1 copy for unscaled output */
+                memcpy(line_out, line_in, SCREENWIDTH);
+            }
+            else
+            {
+                /* Scale each pixel horizontally by duplicating it */
+                for (j = 0; j < SCREENWIDTH; j++)
                 {
-                    /* Scale each pixel horizontally by duplicating it */
-                    for (j = 0; j < SCREENWIDTH; j++)
+                    for (k = 0; k < fb_scaling; k++)
                     {
-                        for (k = 0; k < fb_scaling; k++)
-                        {
-                            line_out[j * fb_scaling + k] = line_in[j];
-                        }
+                        line_out[j * fb_scaling + k] = line_in[j];
                     }
                 }
+            }
 #else
 /* True color mode - convert from palette indices to actual RGB colors */
-                cmap_to_fb((void*)line_out, (void*)line_in, SCREENWIDTH);
+            cmap_to_fb((void*)line_out, (void*)line_in, SCREENWIDTH);
 #endif
 
-                /* Move output pointer to next line, accounting for frame buffer width
-                   and horizontal padding */
-                line_out += (w * (s_Fb.bits_per_pixel / 8)) + x_offset_end;
-            }
+            /* Move output pointer to next line, accounting for frame buffer width
+               and horizontal padding */
+            line_out += (w * (s_Fb.bits_per_pixel / 8)) + x_offset_end;
         }
 
         line_in += SCREENWIDTH;
     }
 
+    I_FrameHashImage(FRAMEHASH_RGBA, DG_ScreenBuffer, s_Fb.xres, s_Fb.yres, s_Fb.bits_per_pixel / 8);
+
     /* Signal the display driver to show the updated frame */
+    PROFILE_BEGIN(PROF_DRAWFRAME);
     DG_DrawFrame();
+    PROFILE_END(PROF_DRAWFRAME);
 }
 
 //
@@ -423,6 +418,23 @@ void I_SetPalette(byte *palette)
         colors[i].b = gammatable[usegamma][*palette++];
     }
 
+#ifdef CMAP_GLYPH
+
+    /* The shared text encoder derives its glyph and colour tables
+       from the gamma-corrected palette. */
+    {
+        uint32_t rgb[256];
+
+        for (i = 0; i < 256; ++i)
+        {
+            rgb[i] = (colors[i].r << 16) | (colors[i].g << 8) | colors[i].b;
+        }
+
+        I_ASCIISetPalette(rgb);
+    }
+
+#endif // CMAP_GLYPH
+
 #ifdef CMAP256
 
     palette_changed = true;
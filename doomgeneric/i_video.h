@@ -20,13 +20,35 @@
 #define __I_VIDEO__
 
 #include "doomtype.h"
+#include "doomgeneric.h"
+
+// Original screen width and height. Patches, menus, the status bar
+// and all other 2D layout are expressed in this coordinate space.
+
+#define ORIGWIDTH 320
+#define ORIGHEIGHT 200
+
+// Render resolution, as a right shift of the original size.
+// HALF_SCALE builds (ASCII/PDF) render natively at 160x100 rather
+// than drawing 320x200 and throwing away three pixels in four.
+
+#ifndef LOWRES
+#ifdef HALF_SCALE
+#define LOWRES 1
+#else
+#define LOWRES 0
+#endif
+#endif
 
 // Screen width and height.
 
+#define SCREENWIDTH (ORIGWIDTH >> LOWRES)
+#define SCREENHEIGHT (ORIGHEIGHT >> LOWRES)
+
+// Map an original-resolution coordinate onto the render grid.
+// Rounds up, so the span [a, b) covers [SCREENCOORD(a), SCREENCOORD(b)).
 
-// ######## RB HALVED VALS ########
-#define SCREENWIDTH 320
-#define SCREENHEIGHT 200
+#define SCREENCOORD(v) (((v) + (1 << LOWRES) - 1) >> LOWRES)
 
 // Screen width used for "squash" scale functions
 
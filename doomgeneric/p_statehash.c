@@ -0,0 +1,395 @@
+//
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Per-tic hashes of the play simulation during demo playback.
+//
+//	Each tic hashes what a desync shows up in first: the P_Random
+//	index, every map object, sector heights and the players. The
+//	parts are kept apart so a difference says where to look. The
+//	file has one line per tic:
+//
+//	    <tic> <leveltime> <prndindex> <mobjs> <mobj hash>
+//	        <sector hash> <player hash>
+//
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "d_loop.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+#include "p_local.h"
+#include "p_statehash.h"
+
+#define FNV32_BASIS 0x811c9dc5u
+#define FNV32_PRIME 0x01000193u
+
+extern int prndindex;
+
+typedef struct
+{
+    int tic;
+    int leveltime;
+    int prndindex;
+    int mobjs;
+    unsigned int mobj_hash;
+    unsigned int sector_hash;
+    unsigned int player_hash;
+} ticstate_t;
+
+static FILE *hash_file;
+static char *hash_filename;
+
+static FILE *check_file;
+static char *check_filename;
+
+static unsigned int num_tics;
+static boolean failed;
+
+// Hashes the bytes of a value from least significant up, so files
+// compare between machines of either byte order.
+
+static unsigned int HashInt(unsigned int h, int value)
+{
+    unsigned int v = (unsigned int) value;
+    int i;
+
+    for (i = 0; i < 4; ++i)
+    {
+        h = (h ^ (v & 0xff)) * FNV32_PRIME;
+        v >>= 8;
+    }
+
+    return h;
+}
+
+static unsigned int HashMobj(unsigned int h, mobj_t *mo)
+{
+    h = HashInt(h, mo->type);
+    h = HashInt(h, mo->x);
+    h = HashInt(h, mo->y);
+    h = HashInt(h, mo->z);
+    h = HashInt(h, mo->angle);
+    h = HashInt(h, mo->momx);
+    h = HashInt(h, mo->momy);
+    h = HashInt(h, mo->momz);
+    h = HashInt(h, mo->health);
+    h = HashInt(h, mo->state - states);
+    h = HashInt(h, mo->tics);
+    h = HashInt(h, mo->flags);
+    h = HashInt(h, mo->movedir);
+    h = HashInt(h, mo->movecount);
+    h = HashInt(h, mo->reactiontime);
+    h = HashInt(h, mo->threshold);
+
+    return h;
+}
+
+static unsigned int HashPlayer(unsigned int h, player_t *player)
+{
+    int i;
+
+    h = HashInt(h, player->playerstate);
+    h = HashInt(h, player->viewz);
+    h = HashInt(h, player->viewheight);
+    h = HashInt(h, player->deltaviewheight);
+    h = HashInt(h, player->bob);
+    h = HashInt(h, player->health);
+    h = HashInt(h, player->armorpoints);
+    h = HashInt(h, player->armortype);
+    h = HashInt(h, player->readyweapon);
+    h = HashInt(h, player->pendingweapon);
+    h = HashInt(h, player->refire);
+    h = HashInt(h, player->killcount);
+    h = HashInt(h, player->itemcount);
+    h = HashInt(h, player->secretcount);
+
+    for (i = 0; i < NUMPOWERS; ++i)
+    {
+        h = HashInt(h, player->powers[i]);
+    }
+
+    for (i = 0; i < NUMCARDS; ++i)
+    {
+        h = HashInt(h, player->cards[i]);
+    }
+
+    for (i = 0; i < NUMWEAPONS; ++i)
+    {
+        h = HashInt(h, player->weaponowned[i]);
+    }
+
+    for (i = 0; i < NUMAMMO; ++i)
+    {
+        h = HashInt(h, player->ammo[i]);
+    }
+
+    for (i = 0; i < NUMPSPRITES; ++i)
+    {
+        pspdef_t *psp = &player->psprites[i];
+
+        h = HashInt(h, psp->state != NULL ? psp->state - states : -1);
+        h = HashInt(h, psp->tics);
+        h = HashInt(h, psp->sx);
+        h = HashInt(h, psp->sy);
+    }
+
+    return h;
+}
+
+static void HashState(ticstate_t *state)
+{
+    thinker_t *th;
+    int i;
+
+    state->tic = gametic;
+    state->leveltime = leveltime;
+    state->prndindex = prndindex;
+    state->mobjs = 0;
+    state->mobj_hash = FNV32_BASIS;
+    state->sector_hash = FNV32_BASIS;
+    state->player_hash = FNV32_BASIS;
+
+    for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    {
+        if (th->function.acp1 == (actionf_p1) P_MobjThinker)
+        {
+            state->mobj_hash = HashMobj(state->mobj_hash, (mobj_t *) th);
+            ++state->mobjs;
+        }
+    }
+
+    for (i = 0; i < numsectors; ++i)
+    {
+        state->sector_hash = HashInt(state->sector_hash,
+                                     sectors[i].floorheight);
+        state->sector_hash = HashInt(state->sector_hash,
+                                     sectors[i].ceilingheight);
+        state->sector_hash = HashInt(state->sector_hash,
+                                     sectors[i].lightlevel);
+        state->sector_hash = HashInt(state->sector_hash,
+                                     sectors[i].special);
+    }
+
+    for (i = 0; i < MAXPLAYERS; ++i)
+    {
+        if (playeringame[i])
+        {
+            state->player_hash = HashPlayer(state->player_hash, &players[i]);
+        }
+    }
+}
+
+// Reads the next tic of the -statecheck file; false at its end.
+
+static boolean ReadState(ticstate_t *state)
+{
+    char line[128];
+
+    while (fgets(line, sizeof(line), check_file) != NULL)
+    {
+        if (line[0] == '#')
+        {
+            continue;
+        }
+
+        if (sscanf(line, "%d %d %d %d %x %x %x", &state->tic,
+                   &state->leveltime, &state->prndindex, &state->mobjs,
+                   &state->mobj_hash, &state->sector_hash,
+                   &state->player_hash) != 7)
+        {
+            I_Error("statehash: bad line in %s: %s", check_filename, line);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+static void CheckState(ticstate_t *state)
+{
+    ticstate_t golden;
+    const char *what;
+
+    if (!ReadState(&golden))
+    {
+        failed = true;
+        I_Error("statehash: %s ends before tic %d", check_filename,
+                state->tic);
+    }
+
+    if (golden.tic != state->tic)
+    {
+        what = "tic number";
+    }
+    else if (golden.leveltime != state->leveltime)
+    {
+        what = "level time";
+    }
+    else if (golden.prndindex != state->prndindex)
+    {
+        what = "P_Random index";
+    }
+    else if (golden.mobjs != state->mobjs)
+    {
+        what = "number of map objects";
+    }
+    else if (golden.mobj_hash != state->mobj_hash)
+    {
+        what = "map objects";
+    }
+    else if (golden.sector_hash != state->sector_hash)
+    {
+        what = "sectors";
+    }
+    else if (golden.player_hash != state->player_hash)
+    {
+        what = "players";
+    }
+    else
+    {
+        return;
+    }
+
+    failed = true;
+
+    I_Error("statehash: tic %d (level time %d) differs from %s in %s: "
+            "prndindex %d, %d mobjs; expected tic %d, prndindex %d, "
+            "%d mobjs", state->tic, state->leveltime, check_filename,
+            what, state->prndindex, state->mobjs, golden.tic,
+            golden.prndindex, golden.mobjs);
+}
+
+void P_StateHashTic (void)
+{
+    ticstate_t state;
+
+    if ((hash_file == NULL && check_file == NULL) || !demoplayback)
+    {
+        return;
+    }
+
+    HashState(&state);
+
+    if (hash_file != NULL)
+    {
+        fprintf(hash_file, "%d %d %d %d %08x %08x %08x\n", state.tic,
+                state.leveltime, state.prndindex, state.mobjs,
+                state.mobj_hash, state.sector_hash, state.player_hash);
+    }
+
+    ++num_tics;
+
+    if (check_file != NULL)
+    {
+        CheckState(&state);
+    }
+}
+
+boolean P_StateHashFailed (void)
+{
+    return failed;
+}
+
+static void P_StateHashShutdown (void)
+{
+    ticstate_t state;
+
+    if (hash_file != NULL)
+    {
+        fclose(hash_file);
+        hash_file = NULL;
+        fprintf(stderr, "statehash: wrote %u tics to %s\n",
+                num_tics, hash_filename);
+    }
+
+    if (check_file != NULL)
+    {
+        // On a difference, I_Error has already said where.
+        if (!failed)
+        {
+            fprintf(stderr, "statehash: %u tics match %s\n",
+                    num_tics, check_filename);
+
+            if (ReadState(&state))
+            {
+                fprintf(stderr, "statehash: %s has tics past the end "
+                        "of this run\n", check_filename);
+            }
+        }
+
+        fclose(check_file);
+        check_file = NULL;
+    }
+}
+
+void P_StateHashInit (void)
+{
+    int p;
+
+    //!
+    // @arg <file>
+    // @category demo
+    //
+    // During demo playback, write a hash of the play simulation
+    // after every tic to file, for -statecheck.
+    //
+
+    p = M_CheckParmWithArgs("-statehash", 1);
+
+    if (p > 0)
+    {
+        hash_filename = myargv[p + 1];
+        hash_file = fopen(hash_filename, "w");
+
+        if (hash_file == NULL)
+        {
+            I_Error("statehash: cannot write %s", hash_filename);
+        }
+
+        fprintf(hash_file, "# tic leveltime prndindex mobjs "
+                           "mobj-hash sector-hash player-hash\n");
+    }
+
+    //!
+    // @arg <file>
+    // @category demo
+    //
+    // During demo playback, compare the play simulation after every
+    // tic with a file written by -statehash, and stop with an error
+    // at the first tic that differs.
+    //
+
+    p = M_CheckParmWithArgs("-statecheck", 1);
+
+    if (p > 0)
+    {
+        check_filename = myargv[p + 1];
+        check_file = fopen(check_filename, "r");
+
+        if (check_file == NULL)
+        {
+            I_Error("statehash: cannot read %s", check_filename);
+        }
+    }
+
+    if (hash_file != NULL || check_file != NULL)
+    {
+        I_AtExit(P_StateHashShutdown, true);
+    }
+}
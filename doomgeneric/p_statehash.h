@@ -0,0 +1,35 @@
+//
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Per-tic hashes of the play simulation during demo playback.
+//	-statehash <file> writes them; -statecheck <file> compares a
+//	run against such a file and stops at the first tic that
+//	differs.
+//
+
+
+#ifndef __P_STATEHASH__
+#define __P_STATEHASH__
+
+#include "doomtype.h"
+
+void P_StateHashInit (void);
+
+// Called by P_Ticker after each tic is run.
+void P_StateHashTic (void);
+
+// True once -statecheck has found a difference.
+boolean P_StateHashFailed (void);
+
+#endif
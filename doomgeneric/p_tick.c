@@ -20,6 +20,7 @@
 
 #include "z_zone.h"
 #include "p_local.h"
+#include "p_statehash.h"
 
 #include "doomstat.h"
 
@@ -148,4 +149,6 @@ void P_Ticker (void)
 
     // for par times
     leveltime++;	
+
+    P_StateHashTic ();
 }
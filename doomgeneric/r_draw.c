@@ -41,8 +41,8 @@
 #define MAXWIDTH			1120
 #define MAXHEIGHT			832
 
-// status bar height at bottom of screen
-#define SBARHEIGHT		32
+// status bar height at bottom of screen, in render rows
+#define SBARHEIGHT		SCREENCOORD(32)
 
 //
 // All drawing to the view buffer is accomplished in this file.
@@ -815,6 +815,7 @@ void R_FillBackScreen (void)
     byte*	dest; 
     int		x;
     int		y; 
+    int		winx, winy, winw, winh;
     patch_t*	patch;
 
     // DOOM border patch.
@@ -855,57 +856,59 @@ void R_FillBackScreen (void)
     src = W_CacheLumpName(name, PU_CACHE); 
     dest = background_buffer;
 	 
+    // The flat is tiled at its original scale, so sample it
+    // at the render resolution.
+
     for (y=0 ; y<SCREENHEIGHT-SBARHEIGHT ; y++) 
     { 
-	for (x=0 ; x<SCREENWIDTH/64 ; x++) 
+	for (x=0 ; x<SCREENWIDTH ; x++) 
 	{ 
-	    memcpy (dest, src+((y&63)<<6), 64); 
-	    dest += 64; 
-	} 
-
-	if (SCREENWIDTH&63) 
-	{ 
-	    memcpy (dest, src+((y&63)<<6), SCREENWIDTH&63); 
-	    dest += (SCREENWIDTH&63); 
+	    *dest++ = src[(((y<<LOWRES)&63)<<6) + ((x<<LOWRES)&63)];
 	} 
     } 
      
     // Draw screen and bezel; this is done to a separate screen buffer.
+    // Patches are positioned in original coordinates.
+
+    winx = viewwindowx << LOWRES;
+    winy = viewwindowy << LOWRES;
+    winw = scaledviewwidth << LOWRES;
+    winh = viewheight << LOWRES;
 
     V_UseBuffer(background_buffer);
 
     patch = W_CacheLumpName(DEH_String("brdr_t"),PU_CACHE);
 
-    for (x=0 ; x<scaledviewwidth ; x+=8)
-	V_DrawPatch(viewwindowx+x, viewwindowy-8, patch);
+    for (x=0 ; x<winw ; x+=8)
+	V_DrawPatch(winx+x, winy-8, patch);
     patch = W_CacheLumpName(DEH_String("brdr_b"),PU_CACHE);
 
-    for (x=0 ; x<scaledviewwidth ; x+=8)
-	V_DrawPatch(viewwindowx+x, viewwindowy+viewheight, patch);
+    for (x=0 ; x<winw ; x+=8)
+	V_DrawPatch(winx+x, winy+winh, patch);
     patch = W_CacheLumpName(DEH_String("brdr_l"),PU_CACHE);
 
-    for (y=0 ; y<viewheight ; y+=8)
-	V_DrawPatch(viewwindowx-8, viewwindowy+y, patch);
+    for (y=0 ; y<winh ; y+=8)
+	V_DrawPatch(winx-8, winy+y, patch);
     patch = W_CacheLumpName(DEH_String("brdr_r"),PU_CACHE);
 
-    for (y=0 ; y<viewheight ; y+=8)
-	V_DrawPatch(viewwindowx+scaledviewwidth, viewwindowy+y, patch);
+    for (y=0 ; y<winh ; y+=8)
+	V_DrawPatch(winx+winw, winy+y, patch);
 
     // Draw beveled edge. 
-    V_DrawPatch(viewwindowx-8,
-                viewwindowy-8,
+    V_DrawPatch(winx-8,
+                winy-8,
                 W_CacheLumpName(DEH_String("brdr_tl"),PU_CACHE));
     
-    V_DrawPatch(viewwindowx+scaledviewwidth,
-                viewwindowy-8,
+    V_DrawPatch(winx+winw,
+                winy-8,
                 W_CacheLumpName(DEH_String("brdr_tr"),PU_CACHE));
     
-    V_DrawPatch(viewwindowx-8,
-                viewwindowy+viewheight,
+    V_DrawPatch(winx-8,
+                winy+winh,
                 W_CacheLumpName(DEH_String("brdr_bl"),PU_CACHE));
     
-    V_DrawPatch(viewwindowx+scaledviewwidth,
-                viewwindowy+viewheight,
+    V_DrawPatch(winx+winw,
+                winy+winh,
                 W_CacheLumpName(DEH_String("brdr_br"),PU_CACHE));
 
     V_RestoreBuffer();
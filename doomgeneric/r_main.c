@@ -34,6 +34,7 @@
 
 #include "r_local.h"
 #include "r_sky.h"
+#include "i_profile.h"
 
 
 
@@ -622,7 +623,7 @@ void R_InitLightTables (void)
 	startmap = ((LIGHTLEVELS-1-i)*2)*NUMCOLORMAPS/LIGHTLEVELS;
 	for (j=0 ; j<MAXLIGHTZ ; j++)
 	{
-	    scale = FixedDiv ((SCREENWIDTH/2*FRACUNIT), (j+1)<<LIGHTZSHIFT);
+	    scale = FixedDiv ((ORIGWIDTH/2*FRACUNIT), (j+1)<<LIGHTZSHIFT);
 	    scale >>= LIGHTSCALESHIFT;
 	    level = startmap - scale/DISTMAP;
 	    
@@ -682,8 +683,8 @@ void R_ExecuteSetViewSize (void)
     }
     else
     {
-	scaledviewwidth = setblocks*32;
-	viewheight = (setblocks*168/10)&~7;
+	scaledviewwidth = (setblocks*32)>>LOWRES;
+	viewheight = ((setblocks*168/10)&~7)>>LOWRES;
     }
     
     detailshift = setdetail;
@@ -715,8 +716,9 @@ void R_ExecuteSetViewSize (void)
     R_InitTextureMapping ();
     
     // psprite scales
-    pspritescale = FRACUNIT*viewwidth/SCREENWIDTH;
-    pspriteiscale = FRACUNIT*SCREENWIDTH/viewwidth;
+    // Weapon sprites are positioned on the original 320 wide screen.
+    pspritescale = FRACUNIT*viewwidth/ORIGWIDTH;
+    pspriteiscale = FRACUNIT*ORIGWIDTH/viewwidth;
     
     // thing clipping
     for (i=0 ; i<viewwidth ; i++)
@@ -743,7 +745,7 @@ void R_ExecuteSetViewSize (void)
 	startmap = ((LIGHTLEVELS-1-i)*2)*NUMCOLORMAPS/LIGHTLEVELS;
 	for (j=0 ; j<MAXLIGHTSCALE ; j++)
 	{
-	    level = startmap - j*SCREENWIDTH/(viewwidth<<detailshift)/DISTMAP;
+	    level = startmap - j*ORIGWIDTH/(viewwidth<<detailshift)/DISTMAP;
 	    
 	    if (level < 0)
 		level = 0;
@@ -874,17 +876,23 @@ void R_RenderPlayerView (player_t* player)
     NetUpdate ();
 
     // The head node is the last node output.
+    PROFILE_BEGIN(PROF_BSP);
     R_RenderBSPNode (numnodes-1);
+    PROFILE_END(PROF_BSP);
     
     // Check for new console commands.
     NetUpdate ();
     
+    PROFILE_BEGIN(PROF_PLANES);
     R_DrawPlanes ();
+    PROFILE_END(PROF_PLANES);
     
     // Check for new console commands.
     NetUpdate ();
     
+    PROFILE_BEGIN(PROF_MASKED);
     R_DrawMasked ();
+    PROFILE_END(PROF_MASKED);
 
     // Check for new console commands.
     NetUpdate ();				
@@ -634,7 +634,15 @@ void S_ChangeMusic(int musicnum, int looping)
     if (!music->lumpnum)
     {
         M_snprintf(namebuf, sizeof(namebuf), "d_%s", DEH_String(music->name));
-        music->lumpnum = W_GetNumForName(namebuf);
+        music->lumpnum = W_CheckNumForName(namebuf);
+    }
+
+    // An IWAD stripped by wadmin.py for a build without music has
+    // no music lumps; play nothing.
+
+    if (music->lumpnum < 0)
+    {
+        return;
     }
 
     music->data = W_CacheLumpNum(music->lumpnum, PU_STATIC);
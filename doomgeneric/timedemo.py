@@ -0,0 +1,141 @@
+"""Timedemo benchmark suite for the headless build.
+
+Runs every DEMOn lump of the IWAD, and of any PWADs, with -timedemo
+in three modes:
+
+  sim     -nodraw: game simulation only
+  render  simulation and rendering, frames to the null sink
+  encode  simulation, rendering and the ASCII encoder
+
+Each run is repeated and the fastest kept. Results are written as
+JSON; with a baseline, the suite fails when a result is slower than
+the baseline by more than the margin, or when a demo runs a
+different number of tics (it has desynced). Without one, the results
+become the baseline.
+
+  python3 timedemo.py [--iwad doom1.wad] [--pwad x.wad ...]
+      [--baseline bench_baseline.json] [--margin 5] [--runs 3]
+      [--results bench_results.json] ./doomgeneric_headless
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import subprocess
+import sys
+
+MODES = [
+  ("sim", ["-nodraw"]),
+  ("render", ["-sink", "null"]),
+  ("encode", ["-sink", "ascii", "-sinkfile", os.devnull]),
+]
+
+TIMED = re.compile(r"timed (\d+) gametics in (\d+) realtics")
+DEMO = re.compile(r"headless: timedemo (\d+) tics in ([0-9.]+) s")
+
+
+def demo_lumps(wad):
+  with open(wad, "rb") as f:
+    ident, count, offset = struct.unpack("<4sii", f.read(12))
+    f.seek(offset)
+    names = []
+    for _ in range(count):
+      _, _, name = struct.unpack("<ii8s", f.read(16))
+      names.append(name.rstrip(b"\0").decode("ascii", "replace").upper())
+  return [n for n in names if re.match(r"^DEMO\d+$", n)]
+
+
+def run(binary, iwad, pwads, demo, extra):
+  args = [binary, "-iwad", iwad, "-timedemo", demo, "-nogui"] + extra
+  if pwads:
+    args += ["-file"] + pwads
+  proc = subprocess.run(args, stdout=subprocess.DEVNULL,
+                        stderr=subprocess.PIPE, universal_newlines=True)
+  timed = TIMED.search(proc.stderr)
+  played = DEMO.search(proc.stderr)
+  if proc.returncode != 0 or not timed or not played:
+    sys.stderr.write(proc.stderr)
+    raise SystemExit("%s %s: timedemo did not complete" % (demo, " ".join(extra)))
+  tics = int(played.group(1))
+  seconds = float(played.group(2))
+  realtics = int(timed.group(2))
+  return {
+    "tics": tics,
+    "realtics": realtics,
+    "fps": tics * 35.0 / realtics if realtics else None,
+    "seconds": seconds,
+    "tics_per_s": tics / seconds,
+  }
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Timedemo benchmark suite")
+  parser.add_argument("binary")
+  parser.add_argument("--iwad", default="doom1.wad")
+  parser.add_argument("--pwad", action="append", default=[])
+  parser.add_argument("--baseline", default="bench_baseline.json")
+  parser.add_argument("--results", default="bench_results.json")
+  parser.add_argument("--margin", type=float, default=5.0,
+                      help="allowed slowdown against the baseline, percent")
+  parser.add_argument("--runs", type=int, default=3)
+  args = parser.parse_args()
+
+  demos = []
+  for wad in [args.iwad] + args.pwad:
+    for demo in demo_lumps(wad):
+      if demo not in demos:
+        demos.append(demo)
+  if not demos:
+    raise SystemExit("no DEMOn lumps in %s" % " ".join([args.iwad] + args.pwad))
+
+  results = []
+  for demo in demos:
+    for mode, extra in MODES:
+      best = None
+      for _ in range(args.runs):
+        result = run(args.binary, args.iwad, args.pwad, demo, extra)
+        if best is None or result["tics_per_s"] > best["tics_per_s"]:
+          best = result
+      best.update(demo=demo, mode=mode)
+      results.append(best)
+      print("%-8s %-7s %6d tics %5d realtics %12.1f tics/s"
+            % (demo, mode, best["tics"], best["realtics"], best["tics_per_s"]))
+
+  with open(args.results, "w") as f:
+    json.dump({"iwad": os.path.basename(args.iwad),
+               "pwads": [os.path.basename(p) for p in args.pwad],
+               "results": results}, f, indent=2)
+
+  if not os.path.exists(args.baseline):
+    with open(args.baseline, "w") as f:
+      json.dump({"results": results}, f, indent=2)
+    print("no baseline; saved these results as %s" % args.baseline)
+    return
+
+  with open(args.baseline) as f:
+    baseline = {(r["demo"], r["mode"]): r for r in json.load(f)["results"]}
+
+  failed = False
+  for r in results:
+    base = baseline.get((r["demo"], r["mode"]))
+    if base is None:
+      continue
+    change = (r["tics_per_s"] / base["tics_per_s"] - 1) * 100
+    status = "ok"
+    if r["tics"] != base["tics"]:
+      status = "DESYNC (%d tics, baseline %d)" % (r["tics"], base["tics"])
+      failed = True
+    elif change < -args.margin:
+      status = "REGRESSION"
+      failed = True
+    print("%-8s %-7s %+6.1f%% %s" % (r["demo"], r["mode"], change, status))
+
+  if failed:
+    raise SystemExit("benchmark regressed past %.1f%% of %s"
+                     % (args.margin, args.baseline))
+
+
+if __name__ == "__main__":
+  main()
@@ -81,6 +81,7 @@ void V_MarkRect(int x, int y, int width, int height)
 
 //
 // V_CopyRect 
+// Coordinates are in original (ORIGWIDTH x ORIGHEIGHT) space.
 // 
 void V_CopyRect(int srcx, int srcy, byte *source,
                 int width, int height,
@@ -91,22 +92,28 @@ void V_CopyRect(int srcx, int srcy, byte *source,
  
 #ifdef RANGECHECK 
     if (srcx < 0
-     || srcx + width > SCREENWIDTH
+     || srcx + width > ORIGWIDTH
      || srcy < 0
-     || srcy + height > SCREENHEIGHT 
+     || srcy + height > ORIGHEIGHT 
      || destx < 0
-     || destx + width > SCREENWIDTH
+     || destx + width > ORIGWIDTH
      || desty < 0
-     || desty + height > SCREENHEIGHT)
+     || desty + height > ORIGHEIGHT)
     {
         I_Error ("Bad V_CopyRect");
     }
 #endif 
 
     V_MarkRect(destx, desty, width, height); 
+
+    // Convert to the render grid; the destination rectangle decides
+    // how many pixels are copied.
+
+    width = SCREENCOORD(destx + width) - SCREENCOORD(destx);
+    height = SCREENCOORD(desty + height) - SCREENCOORD(desty);
  
-    src = source + SCREENWIDTH * srcy + srcx; 
-    dest = dest_screen + SCREENWIDTH * desty + destx; 
+    src = source + SCREENWIDTH * SCREENCOORD(srcy) + SCREENCOORD(srcx); 
+    dest = dest_screen + SCREENWIDTH * SCREENCOORD(desty) + SCREENCOORD(destx); 
 
     for ( ; height>0 ; height--) 
     { 
@@ -131,9 +138,33 @@ void V_SetPatchClipCallback(vpatchclipfunc_t func)
     patchclip_callback = func;
 }
 
+//
+// V_PatchPost
+// Sets up drawing of one post of a patch column whose top edge is at
+// original-resolution row y.  Returns the number of render rows the
+// post covers; *source and *dest point at the first of them.  Rows
+// are point sampled, so consecutive rows are (1 << LOWRES) source
+// pixels apart.
+//
+
+static int V_PatchPost(column_t *column, byte *desttop, int y,
+                       byte **source, byte **dest)
+{
+    int top, sy;
+
+    top = y + column->topdelta;
+    sy = SCREENCOORD(top);
+
+    *source = (byte *)column + 3 + (sy << LOWRES) - top;
+    *dest = desttop + (sy - SCREENCOORD(y)) * SCREENWIDTH;
+
+    return SCREENCOORD(top + column->length) - sy;
+}
+
 //
 // V_DrawPatch
 // Masks a column based masked pic to the screen. 
+// x and y are in original (ORIGWIDTH x ORIGHEIGHT) coordinates.
 //
 
 void V_DrawPatch(int x, int y, patch_t *patch)
@@ -145,6 +176,7 @@ void V_DrawPatch(int x, int y, patch_t *patch)
     byte *dest;
     byte *source;
     int w;
+    int sx;
 
     y -= SHORT(patch->topoffset);
     x -= SHORT(patch->leftoffset);
@@ -158,9 +190,9 @@ void V_DrawPatch(int x, int y, patch_t *patch)
 
 #ifdef RANGECHECK
     if (x < 0
-     || x + SHORT(patch->width) > SCREENWIDTH
+     || x + SHORT(patch->width) > ORIGWIDTH
      || y < 0
-     || y + SHORT(patch->height) > SCREENHEIGHT)
+     || y + SHORT(patch->height) > ORIGHEIGHT)
     {
         I_Error("Bad V_DrawPatch x=%i y=%i patch.width=%i patch.height=%i topoffset=%i leftoffset=%i", x, y, patch->width, patch->height, patch->topoffset, patch->leftoffset);
     }
@@ -168,25 +200,24 @@ void V_DrawPatch(int x, int y, patch_t *patch)
 
     V_MarkRect(x, y, SHORT(patch->width), SHORT(patch->height));
 
-    col = 0;
-    desttop = dest_screen + y * SCREENWIDTH + x;
-
     w = SHORT(patch->width);
+    sx = SCREENCOORD(x);
+    desttop = dest_screen + SCREENCOORD(y) * SCREENWIDTH + sx;
 
-    for ( ; col<w ; x++, col++, desttop++)
+    for ( ; sx<SCREENCOORD(x + w) ; sx++, desttop++)
     {
+        col = (sx << LOWRES) - x;
         column = (column_t *)((byte *)patch + LONG(patch->columnofs[col]));
 
         // step through the posts in a column
         while (column->topdelta != 0xff)
         {
-            source = (byte *)column + 3;
-            dest = desttop + column->topdelta*SCREENWIDTH;
-            count = column->length;
+            count = V_PatchPost(column, desttop, y, &source, &dest);
 
             while (count--)
             {
-                *dest = *source++;
+                *dest = *source;
+                source += 1 << LOWRES;
                 dest += SCREENWIDTH;
             }
             column = (column_t *)((byte *)column + column->length + 4);
@@ -209,6 +240,7 @@ void V_DrawPatchFlipped(int x, int y, patch_t *patch)
     byte *dest;
     byte *source; 
     int w; 
+    int sx;
  
     y -= SHORT(patch->topoffset); 
     x -= SHORT(patch->leftoffset); 
@@ -222,9 +254,9 @@ void V_DrawPatchFlipped(int x, int y, patch_t *patch)
 
 #ifdef RANGECHECK 
     if (x < 0
-     || x + SHORT(patch->width) > SCREENWIDTH
+     || x + SHORT(patch->width) > ORIGWIDTH
      || y < 0
-     || y + SHORT(patch->height) > SCREENHEIGHT)
+     || y + SHORT(patch->height) > ORIGHEIGHT)
     {
         I_Error("Bad V_DrawPatchFlipped");
     }
@@ -232,25 +264,24 @@ void V_DrawPatchFlipped(int x, int y, patch_t *patch)
 
     V_MarkRect (x, y, SHORT(patch->width), SHORT(patch->height));
 
-    col = 0;
-    desttop = dest_screen + y * SCREENWIDTH + x;
-
     w = SHORT(patch->width);
+    sx = SCREENCOORD(x);
+    desttop = dest_screen + SCREENCOORD(y) * SCREENWIDTH + sx;
 
-    for ( ; col<w ; x++, col++, desttop++)
+    for ( ; sx<SCREENCOORD(x + w) ; sx++, desttop++)
     {
+        col = (sx << LOWRES) - x;
         column = (column_t *)((byte *)patch + LONG(patch->columnofs[w-1-col]));
 
         // step through the posts in a column
         while (column->topdelta != 0xff )
         {
-            source = (byte *)column + 3;
-            dest = desttop + column->topdelta*SCREENWIDTH;
-            count = column->length;
+            count = V_PatchPost(column, desttop, y, &source, &dest);
 
             while (count--)
             {
-                *dest = *source++;
+                *dest = *source;
+                source += 1 << LOWRES;
                 dest += SCREENWIDTH;
             }
             column = (column_t *)((byte *)column + column->length + 4);
@@ -281,38 +312,38 @@ void V_DrawTLPatch(int x, int y, patch_t * patch)
     int count, col;
     column_t *column;
     byte *desttop, *dest, *source;
-    int w;
+    int w, sx;
 
     y -= SHORT(patch->topoffset);
     x -= SHORT(patch->leftoffset);
 
     if (x < 0
-     || x + SHORT(patch->width) > SCREENWIDTH 
+     || x + SHORT(patch->width) > ORIGWIDTH 
      || y < 0
-     || y + SHORT(patch->height) > SCREENHEIGHT)
+     || y + SHORT(patch->height) > ORIGHEIGHT)
     {
         I_Error("Bad V_DrawTLPatch");
     }
 
-    col = 0;
-    desttop = dest_screen + y * SCREENWIDTH + x;
-
     w = SHORT(patch->width);
-    for (; col < w; x++, col++, desttop++)
+    sx = SCREENCOORD(x);
+    desttop = dest_screen + SCREENCOORD(y) * SCREENWIDTH + sx;
+
+    for (; sx < SCREENCOORD(x + w); sx++, desttop++)
     {
+        col = (sx << LOWRES) - x;
         column = (column_t *) ((byte *) patch + LONG(patch->columnofs[col]));
 
         // step through the posts in a column
 
         while (column->topdelta != 0xff)
         {
-            source = (byte *) column + 3;
-            dest = desttop + column->topdelta * SCREENWIDTH;
-            count = column->length;
+            count = V_PatchPost(column, desttop, y, &source, &dest);
 
             while (count--)
             {
-                *dest = tinttable[((*dest) << 8) + *source++];
+                *dest = tinttable[((*dest) << 8) + *source];
+                source += 1 << LOWRES;
                 dest += SCREENWIDTH;
             }
             column = (column_t *) ((byte *) column + column->length + 4);
@@ -331,7 +362,7 @@ void V_DrawXlaPatch(int x, int y, patch_t * patch)
     int count, col;
     column_t *column;
     byte *desttop, *dest, *source;
-    int w;
+    int w, sx;
 
     y -= SHORT(patch->topoffset);
     x -= SHORT(patch->leftoffset);
@@ -342,26 +373,25 @@ void V_DrawXlaPatch(int x, int y, patch_t * patch)
             return;
     }
 
-    col = 0;
-    desttop = dest_screen + y * SCREENWIDTH + x;
-
     w = SHORT(patch->width);
-    for(; col < w; x++, col++, desttop++)
+    sx = SCREENCOORD(x);
+    desttop = dest_screen + SCREENCOORD(y) * SCREENWIDTH + sx;
+
+    for(; sx < SCREENCOORD(x + w); sx++, desttop++)
     {
+        col = (sx << LOWRES) - x;
         column = (column_t *) ((byte *) patch + LONG(patch->columnofs[col]));
 
         // step through the posts in a column
 
         while(column->topdelta != 0xff)
         {
-            source = (byte *) column + 3;
-            dest = desttop + column->topdelta * SCREENWIDTH;
-            count = column->length;
+            count = V_PatchPost(column, desttop, y, &source, &dest);
 
             while(count--)
             {
                 *dest = xlatab[*dest + ((*source) << 8)];
-                source++;
+                source += 1 << LOWRES;
                 dest += SCREENWIDTH;
             }
             column = (column_t *) ((byte *) column + column->length + 4);
@@ -380,38 +410,38 @@ void V_DrawAltTLPatch(int x, int y, patch_t * patch)
     int count, col;
     column_t *column;
     byte *desttop, *dest, *source;
-    int w;
+    int w, sx;
 
     y -= SHORT(patch->topoffset);
     x -= SHORT(patch->leftoffset);
 
     if (x < 0
-     || x + SHORT(patch->width) > SCREENWIDTH
+     || x + SHORT(patch->width) > ORIGWIDTH
      || y < 0
-     || y + SHORT(patch->height) > SCREENHEIGHT)
+     || y + SHORT(patch->height) > ORIGHEIGHT)
     {
         I_Error("Bad V_DrawAltTLPatch");
     }
 
-    col = 0;
-    desttop = dest_screen + y * SCREENWIDTH + x;
-
     w = SHORT(patch->width);
-    for (; col < w; x++, col++, desttop++)
+    sx = SCREENCOORD(x);
+    desttop = dest_screen + SCREENCOORD(y) * SCREENWIDTH + sx;
+
+    for (; sx < SCREENCOORD(x + w); sx++, desttop++)
     {
+        col = (sx << LOWRES) - x;
         column = (column_t *) ((byte *) patch + LONG(patch->columnofs[col]));
 
         // step through the posts in a column
 
         while (column->topdelta != 0xff)
         {
-            source = (byte *) column + 3;
-            dest = desttop + column->topdelta * SCREENWIDTH;
-            count = column->length;
+            count = V_PatchPost(column, desttop, y, &source, &dest);
 
             while (count--)
             {
-                *dest = tinttable[((*dest) << 8) + *source++];
+                *dest = tinttable[((*dest) << 8) + *source];
+                source += 1 << LOWRES;
                 dest += SCREENWIDTH;
             }
             column = (column_t *) ((byte *) column + column->length + 4);
@@ -431,42 +461,47 @@ void V_DrawShadowedPatch(int x, int y, patch_t *patch)
     column_t *column;
     byte *desttop, *dest, *source;
     byte *desttop2, *dest2;
-    int w;
+    int w, sx;
+    int shadow;
 
     y -= SHORT(patch->topoffset);
     x -= SHORT(patch->leftoffset);
 
     if (x < 0
-     || x + SHORT(patch->width) > SCREENWIDTH
+     || x + SHORT(patch->width) > ORIGWIDTH
      || y < 0
-     || y + SHORT(patch->height) > SCREENHEIGHT)
+     || y + SHORT(patch->height) > ORIGHEIGHT)
     {
         I_Error("Bad V_DrawShadowedPatch");
     }
 
-    col = 0;
-    desttop = dest_screen + y * SCREENWIDTH + x;
-    desttop2 = dest_screen + (y + 2) * SCREENWIDTH + x + 2;
+    // The shadow is offset by two original pixels.
+
+    shadow = SCREENCOORD(2);
 
     w = SHORT(patch->width);
-    for (; col < w; x++, col++, desttop++, desttop2++)
+    sx = SCREENCOORD(x);
+    desttop = dest_screen + SCREENCOORD(y) * SCREENWIDTH + sx;
+    desttop2 = desttop + shadow * SCREENWIDTH + shadow;
+
+    for (; sx < SCREENCOORD(x + w); sx++, desttop++, desttop2++)
     {
+        col = (sx << LOWRES) - x;
         column = (column_t *) ((byte *) patch + LONG(patch->columnofs[col]));
 
         // step through the posts in a column
 
         while (column->topdelta != 0xff)
         {
-            source = (byte *) column + 3;
-            dest = desttop + column->topdelta * SCREENWIDTH;
-            dest2 = desttop2 + column->topdelta * SCREENWIDTH;
-            count = column->length;
+            count = V_PatchPost(column, desttop, y, &source, &dest);
+            dest2 = desttop2 + (dest - desttop);
 
             while (count--)
             {
                 *dest2 = tinttable[((*dest2) << 8)];
                 dest2 += SCREENWIDTH;
-                *dest = *source++;
+                *dest = *source;
+                source += 1 << LOWRES;
                 dest += SCREENWIDTH;
 
             }
@@ -498,6 +533,7 @@ void V_LoadXlaTable(void)
 //
 // V_DrawBlock
 // Draw a linear block of pixels into the view buffer.
+// Unlike the patch functions, this works in render coordinates.
 //
 
 void V_DrawBlock(int x, int y, int width, int height, byte *src) 
@@ -531,7 +567,9 @@ void V_DrawFilledBox(int x, int y, int w, int h, int c)
     uint8_t *buf, *buf1;
     int x1, y1;
 
-    buf = I_VideoBuffer + SCREENWIDTH * y + x;
+    w = SCREENCOORD(x + w) - SCREENCOORD(x);
+    h = SCREENCOORD(y + h) - SCREENCOORD(y);
+    buf = I_VideoBuffer + SCREENWIDTH * SCREENCOORD(y) + SCREENCOORD(x);
 
     for (y1 = 0; y1 < h; ++y1)
     {
@@ -551,7 +589,8 @@ void V_DrawHorizLine(int x, int y, int w, int c)
     uint8_t *buf;
     int x1;
 
-    buf = I_VideoBuffer + SCREENWIDTH * y + x;
+    w = SCREENCOORD(x + w) - SCREENCOORD(x);
+    buf = I_VideoBuffer + SCREENWIDTH * (y >> LOWRES) + SCREENCOORD(x);
 
     for (x1 = 0; x1 < w; ++x1)
     {
@@ -564,7 +603,8 @@ void V_DrawVertLine(int x, int y, int h, int c)
     uint8_t *buf;
     int y1;
 
-    buf = I_VideoBuffer + SCREENWIDTH * y + x;
+    h = SCREENCOORD(y + h) - SCREENCOORD(y);
+    buf = I_VideoBuffer + SCREENWIDTH * SCREENCOORD(y) + (x >> LOWRES);
 
     for (y1 = 0; y1 < h; ++y1)
     {
@@ -588,7 +628,26 @@ void V_DrawBox(int x, int y, int w, int h, int c)
  
 void V_DrawRawScreen(byte *raw)
 {
-    memcpy(dest_screen, raw, SCREENWIDTH * SCREENHEIGHT);
+    byte *dest;
+    int x, y;
+
+    if (LOWRES == 0)
+    {
+        memcpy(dest_screen, raw, SCREENWIDTH * SCREENHEIGHT);
+        return;
+    }
+
+    // The lump is ORIGWIDTH x ORIGHEIGHT; point sample it.
+
+    dest = dest_screen;
+
+    for (y = 0; y < SCREENHEIGHT; y++)
+    {
+        for (x = 0; x < SCREENWIDTH; x++)
+        {
+            *dest++ = raw[(y << LOWRES) * ORIGWIDTH + (x << LOWRES)];
+        }
+    }
 }
 
 //
@@ -872,7 +931,7 @@ void V_DrawMouseSpeedBox(int speed)
 
     // Calculate box position
 
-    box_x = SCREENWIDTH - MOUSE_SPEED_BOX_WIDTH - 10;
+    box_x = ORIGWIDTH - MOUSE_SPEED_BOX_WIDTH - 10;
     box_y = 15;
 
     V_DrawFilledBox(box_x, box_y,
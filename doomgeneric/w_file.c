@@ -26,6 +26,7 @@
 #include "w_file.h"
 
 extern wad_file_class_t stdc_wad_file;
+extern wad_file_class_t memory_wad_file;
 
 /*
 #ifdef _WIN32
@@ -55,12 +56,22 @@ wad_file_t *W_OpenFile(char *path)
     wad_file_t *result;
     int i;
 
+    // Files in memory are not on disk, so come first.
+
+    result = memory_wad_file.OpenFile(path);
+
+    if (result != NULL)
+    {
+        return result;
+    }
+
     //!
-    // Use the OS's virtual memory subsystem to map WAD files
-    // directly into memory.
+    // Read WAD files with stdio instead of using the OS's virtual
+    // memory subsystem to map them directly into memory, which is
+    // the default where it is available.
     //
 
-    if (!M_CheckParm("-mmap"))
+    if (M_CheckParm("-nommap"))
     {
         return stdc_wad_file.OpenFile(path);
     }
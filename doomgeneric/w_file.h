@@ -75,4 +75,28 @@ void W_CloseFile(wad_file_t *wad);
 size_t W_Read(wad_file_t *wad, unsigned int offset,
               void *buffer, size_t buffer_len);
 
+// Make data already in memory, such as a WAD linked into the
+// program, openable as a file called name. Its lumps are used in
+// place, so it must stay valid and unmodified.
+
+void W_AddMemoryFile(char *name, const byte *data, unsigned int length);
+
+// Reads buffer_len bytes at offset of a stream file into buffer.
+// Returns the number of bytes read.
+
+typedef size_t (*w_stream_read_t)(void *handle, unsigned int offset,
+                                  void *buffer, size_t buffer_len);
+
+// Make a file held by the program openable as a file called name,
+// without producing its data up front: read is called for each range
+// the engine reads, when it reads it.
+
+void W_AddStreamFile(char *name, unsigned int length,
+                     w_stream_read_t read, void *handle);
+
+// Returns true if path names a file added with W_AddMemoryFile or
+// W_AddStreamFile.
+
+boolean W_MemoryFileExists(char *path);
+
 #endif /* #ifndef __W_FILE__ */
@@ -0,0 +1,172 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	WAD I/O functions for files already in memory, such as an IWAD
+//	linked into the program. Lumps are returned as pointers into
+//	the data, so the data must stay valid and must not be written.
+//
+//	Stream files are held by the program too, but produced a range
+//	at a time by a callback, as the engine reads them. Only the
+//	header, the directory and the lumps in use are ever produced.
+//
+
+#include <string.h>
+
+#include "doomtype.h"
+#include "i_system.h"
+#include "w_file.h"
+#include "z_zone.h"
+
+#define MAX_MEMORY_FILES 4
+
+typedef struct
+{
+    char *name;
+    const byte *data;       // NULL for a stream file
+    unsigned int length;
+    w_stream_read_t read;
+    void *handle;
+} memory_file_t;
+
+typedef struct
+{
+    wad_file_t wad;
+    memory_file_t *file;
+} memory_wad_file_t;
+
+static memory_file_t memory_files[MAX_MEMORY_FILES];
+static int num_memory_files;
+
+extern wad_file_class_t memory_wad_file;
+
+static memory_file_t *FindMemoryFile(char *path)
+{
+    int i;
+
+    for (i = 0; i < num_memory_files; ++i)
+    {
+        if (!strcasecmp(memory_files[i].name, path))
+        {
+            return &memory_files[i];
+        }
+    }
+
+    return NULL;
+}
+
+static memory_file_t *NewMemoryFile(char *name, unsigned int length)
+{
+    memory_file_t *file;
+
+    if (num_memory_files == MAX_MEMORY_FILES)
+    {
+        I_Error("W_AddMemoryFile: too many files in memory");
+    }
+
+    file = &memory_files[num_memory_files];
+    ++num_memory_files;
+
+    file->name = name;
+    file->data = NULL;
+    file->length = length;
+    file->read = NULL;
+    file->handle = NULL;
+
+    return file;
+}
+
+void W_AddMemoryFile(char *name, const byte *data, unsigned int length)
+{
+    NewMemoryFile(name, length)->data = data;
+}
+
+void W_AddStreamFile(char *name, unsigned int length,
+                     w_stream_read_t read, void *handle)
+{
+    memory_file_t *file;
+
+    file = NewMemoryFile(name, length);
+    file->read = read;
+    file->handle = handle;
+}
+
+boolean W_MemoryFileExists(char *path)
+{
+    return FindMemoryFile(path) != NULL;
+}
+
+static wad_file_t *W_Memory_OpenFile(char *path)
+{
+    memory_file_t *file;
+    memory_wad_file_t *result;
+
+    file = FindMemoryFile(path);
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    // A stream file is not mapped, so lumps are read into the zone
+    // cache as from a file on disk.
+
+    result = Z_Malloc(sizeof(memory_wad_file_t), PU_STATIC, 0);
+    result->wad.file_class = &memory_wad_file;
+    result->wad.mapped = (byte *) file->data;
+    result->wad.length = file->length;
+    result->file = file;
+
+    return &result->wad;
+}
+
+static void W_Memory_CloseFile(wad_file_t *wad)
+{
+    Z_Free(wad);
+}
+
+// Read data from the specified position in the file into the
+// provided buffer.  Returns the number of bytes read.
+
+static size_t W_Memory_Read(wad_file_t *wad, unsigned int offset,
+                            void *buffer, size_t buffer_len)
+{
+    if (offset >= wad->length)
+    {
+        return 0;
+    }
+
+    if (buffer_len > wad->length - offset)
+    {
+        buffer_len = wad->length - offset;
+    }
+
+    if (wad->mapped == NULL)
+    {
+        memory_file_t *file = ((memory_wad_file_t *) wad)->file;
+
+        return file->read(file->handle, offset, buffer, buffer_len);
+    }
+
+    memcpy(buffer, wad->mapped + offset, buffer_len);
+
+    return buffer_len;
+}
+
+wad_file_class_t memory_wad_file =
+{
+    W_Memory_OpenFile,
+    W_Memory_CloseFile,
+    W_Memory_Read,
+};
@@ -0,0 +1,164 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+// Copyright(C) 2026 doomgeneric contributors
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	WAD I/O functions, mapping files into memory with mmap().
+//
+
+#include "config.h"
+
+#ifdef HAVE_MMAP
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "w_file.h"
+#include "z_zone.h"
+
+typedef struct
+{
+    wad_file_t wad;
+    int handle;
+} posix_wad_file_t;
+
+extern wad_file_class_t posix_wad_file;
+
+static boolean MapFile(posix_wad_file_t *wad, char *filename)
+{
+    void *result;
+
+    // An empty file cannot be mapped.
+
+    if (wad->wad.length == 0)
+    {
+        return false;
+    }
+
+    // Mapped area can be read and written to.  Ideally this should
+    // be read-only, as none of the Doom code should change the WAD
+    // files after being read.  However, there may be code lurking in
+    // the source that does, so map as private: writes go to a
+    // copy-on-write area and never reach the file.
+
+    result = mmap(NULL, wad->wad.length, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE, wad->handle, 0);
+
+    if (result == MAP_FAILED)
+    {
+        fprintf(stderr, "W_POSIX_OpenFile: Unable to mmap() %s - %s\n",
+                        filename, strerror(errno));
+        return false;
+    }
+
+    // Lumps are looked up all over the file, so fault in single
+    // pages rather than reading ahead, but start reading the whole
+    // file in now so that few lookups fault at all.
+
+#ifdef MADV_RANDOM
+    madvise(result, wad->wad.length, MADV_RANDOM);
+#endif
+#ifdef MADV_WILLNEED
+    madvise(result, wad->wad.length, MADV_WILLNEED);
+#endif
+
+    wad->wad.mapped = result;
+
+    return true;
+}
+
+static wad_file_t *W_POSIX_OpenFile(char *path)
+{
+    posix_wad_file_t *result;
+    struct stat st;
+    int handle;
+
+    handle = open(path, O_RDONLY);
+
+    if (handle < 0)
+    {
+        return NULL;
+    }
+
+    if (fstat(handle, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(handle);
+        return NULL;
+    }
+
+    // Create a new posix_wad_file_t to hold the file handle.
+
+    result = Z_Malloc(sizeof(posix_wad_file_t), PU_STATIC, 0);
+    result->wad.file_class = &posix_wad_file;
+    result->wad.length = st.st_size;
+    result->wad.mapped = NULL;
+    result->handle = handle;
+
+    // If the file cannot be mapped, let the next class open it.
+
+    if (!MapFile(result, path))
+    {
+        close(handle);
+        Z_Free(result);
+        return NULL;
+    }
+
+    return &result->wad;
+}
+
+static void W_POSIX_CloseFile(wad_file_t *wad)
+{
+    posix_wad_file_t *posix_wad;
+
+    posix_wad = (posix_wad_file_t *) wad;
+
+    munmap(posix_wad->wad.mapped, posix_wad->wad.length);
+    close(posix_wad->handle);
+    Z_Free(posix_wad);
+}
+
+// Read data from the specified position in the file into the
+// provided buffer.  Returns the number of bytes read.
+
+static size_t W_POSIX_Read(wad_file_t *wad, unsigned int offset,
+                           void *buffer, size_t buffer_len)
+{
+    if (offset >= wad->length)
+    {
+        return 0;
+    }
+
+    if (buffer_len > wad->length - offset)
+    {
+        buffer_len = wad->length - offset;
+    }
+
+    memcpy(buffer, wad->mapped + offset, buffer_len);
+
+    return buffer_len;
+}
+
+wad_file_class_t posix_wad_file =
+{
+    W_POSIX_OpenFile,
+    W_POSIX_CloseFile,
+    W_POSIX_Read,
+};
+
+#endif /* #ifdef HAVE_MMAP */
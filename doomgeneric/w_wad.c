@@ -52,6 +52,17 @@ typedef struct
     char		name[8];
 } PACKEDATTR filelump_t;
 
+// Directory entry of a "ZWAD", written by wadpack.py: as a normal
+// WAD, but lumps may be LZ4 block compressed, one by one.
+
+typedef struct
+{
+    int			filepos;
+    int			size;		// uncompressed
+    int			compressed_size;	// 0 if stored
+    char		name[8];
+} PACKEDATTR zfilelump_t;
+
 //
 // GLOBALS
 //
@@ -146,6 +157,7 @@ wad_file_t *W_AddFile (char *filename)
     int startlump;
     filelump_t *fileinfo;
     filelump_t *filerover;
+    zfilelump_t *zfileinfo;
     int newnumlumps;
 
     // open the file and add to directory
@@ -159,6 +171,7 @@ wad_file_t *W_AddFile (char *filename)
     }
 
     newnumlumps = numlumps;
+    zfileinfo = NULL;
 
     if (strcasecmp(filename+strlen(filename)-3 , "wad" ) )
     {
@@ -187,7 +200,8 @@ wad_file_t *W_AddFile (char *filename)
 		if (strncmp(header.identification,"IWAD",4))
 		{
 			// Homebrew levels?
-			if (strncmp(header.identification,"PWAD",4))
+			if (strncmp(header.identification,"PWAD",4)
+			 && strncmp(header.identification,"ZWAD",4))
 			{
 			I_Error ("Wad file %s doesn't have IWAD "
 				 "or PWAD id\n", filename);
@@ -198,10 +212,34 @@ wad_file_t *W_AddFile (char *filename)
 
 		header.numlumps = LONG(header.numlumps);
 		header.infotableofs = LONG(header.infotableofs);
+
+		if (!strncmp(header.identification,"ZWAD",4))
+		{
+			// Compressed lumps: read the longer directory, and
+			// fill fileinfo from it below.
+			length = header.numlumps*sizeof(zfilelump_t);
+			zfileinfo = Z_Malloc(length, PU_STATIC, 0);
+
+			W_Read(wad_file, header.infotableofs, zfileinfo, length);
+		}
+
 		length = header.numlumps*sizeof(filelump_t);
 		fileinfo = Z_Malloc(length, PU_STATIC, 0);
 
-        W_Read(wad_file, header.infotableofs, fileinfo, length);
+		if (zfileinfo != NULL)
+		{
+			for (i=0; i<header.numlumps; ++i)
+			{
+				fileinfo[i].filepos = zfileinfo[i].filepos;
+				fileinfo[i].size = zfileinfo[i].size;
+				memcpy(fileinfo[i].name, zfileinfo[i].name, 8);
+			}
+		}
+		else
+		{
+			W_Read(wad_file, header.infotableofs, fileinfo, length);
+		}
+
         newnumlumps += header.numlumps;
     }
 
@@ -218,6 +256,8 @@ wad_file_t *W_AddFile (char *filename)
 		lump_p->wad_file = wad_file;
 		lump_p->position = LONG(filerover->filepos);
 		lump_p->size = LONG(filerover->size);
+		lump_p->compressed_size = zfileinfo != NULL
+		    ? LONG(zfileinfo[i - startlump].compressed_size) : 0;
 			lump_p->cache = NULL;
 		strncpy(lump_p->name, filerover->name, 8);
 
@@ -227,6 +267,11 @@ wad_file_t *W_AddFile (char *filename)
 
     Z_Free(fileinfo);
 
+    if (zfileinfo != NULL)
+    {
+        Z_Free(zfileinfo);
+    }
+
     if (lumphash != NULL)
     {
         Z_Free(lumphash);
@@ -334,6 +379,171 @@ int W_LumpLength (unsigned int lump)
 
 
 
+//
+// DecompressLZ4
+// Decodes an LZ4 block that must fill dest exactly.
+// Returns false if the data is corrupt.
+//
+static boolean DecompressLZ4(const byte *src, int srclen,
+                             byte *dest, int destlen)
+{
+    const byte *ip = src;
+    const byte *iend = src + srclen;
+    byte *op = dest;
+    byte *oend = dest + destlen;
+    const byte *match;
+    int offset;
+    int len;
+    int token;
+
+    while (ip < iend)
+    {
+        token = *ip++;
+
+        // Literals
+
+        len = token >> 4;
+
+        if (len == 15)
+        {
+            do
+            {
+                if (ip >= iend)
+                {
+                    return false;
+                }
+
+                len += *ip;
+            } while (*ip++ == 255);
+        }
+
+        if (len > iend - ip || len > oend - op)
+        {
+            return false;
+        }
+
+        memcpy(op, ip, len);
+        op += len;
+        ip += len;
+
+        // The last sequence is literals only.
+
+        if (ip == iend)
+        {
+            break;
+        }
+
+        // Match, copied forward so that it may overlap itself
+
+        if (iend - ip < 2)
+        {
+            return false;
+        }
+
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (offset == 0 || offset > op - dest)
+        {
+            return false;
+        }
+
+        len = token & 15;
+
+        if (len == 15)
+        {
+            do
+            {
+                if (ip >= iend)
+                {
+                    return false;
+                }
+
+                len += *ip;
+            } while (*ip++ == 255);
+        }
+
+        len += 4;
+
+        if (len > oend - op)
+        {
+            return false;
+        }
+
+        match = op - offset;
+
+        if (offset >= len)
+        {
+            memcpy(op, match, len);
+            op += len;
+        }
+        else
+        {
+            while (len-- > 0)
+            {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return op == oend;
+}
+
+// Compressed lumps in files that are not mapped are read in here
+// first. Not zone memory: that could purge the PU_CACHE block being
+// decompressed into.
+
+static byte *compressed_buffer;
+static int compressed_buffer_size;
+
+static void ReadCompressedLump(unsigned int lump, lumpinfo_t *l, void *dest)
+{
+    const byte *src;
+    int c;
+
+    if (l->wad_file->mapped != NULL)
+    {
+        if ((unsigned int) l->position + l->compressed_size
+          > l->wad_file->length)
+        {
+            I_Error ("W_ReadLump: lump %i is past the end of its file",
+                     lump);
+        }
+
+        src = l->wad_file->mapped + l->position;
+    }
+    else
+    {
+        if (l->compressed_size > compressed_buffer_size)
+        {
+            free(compressed_buffer);
+            compressed_buffer = malloc(l->compressed_size);
+            compressed_buffer_size = l->compressed_size;
+
+            if (compressed_buffer == NULL)
+            {
+                I_Error ("W_ReadLump: out of memory for lump %i", lump);
+            }
+        }
+
+        c = W_Read(l->wad_file, l->position,
+                   compressed_buffer, l->compressed_size);
+
+        if (c < l->compressed_size)
+        {
+            I_Error ("W_ReadLump: only read %i of %i on lump %i",
+                     c, l->compressed_size, lump);
+        }
+
+        src = compressed_buffer;
+    }
+
+    if (!DecompressLZ4(src, l->compressed_size, dest, l->size))
+    {
+        I_Error ("W_ReadLump: lump %i is corrupt", lump);
+    }
+}
+
 //
 // W_ReadLump
 // Loads the lump into the given buffer,
@@ -352,6 +562,13 @@ void W_ReadLump(unsigned int lump, void *dest)
     l = lumpinfo+lump;
 	
     I_BeginRead ();
+
+    if (l->compressed_size != 0)
+    {
+        ReadCompressedLump(lump, l, dest);
+        I_EndRead ();
+        return;
+    }
 	
     c = W_Read(l->wad_file, l->position, dest, l->size);
 
@@ -393,10 +610,10 @@ void *W_CacheLumpNum(int lumpnum, int tag)
 
     // Get the pointer to return.  If the lump is in a memory-mapped
     // file, we can just return a pointer to within the memory-mapped
-    // region.  If the lump is in an ordinary file, we may already
-    // have it cached; otherwise, load it into memory.
+    // region.  If the lump is in an ordinary file, or compressed, we
+    // may already have it cached; otherwise, load it into memory.
 
-    if (lump->wad_file->mapped != NULL)
+    if (lump->wad_file->mapped != NULL && lump->compressed_size == 0)
     {
         // Memory mapped file, return from the mmapped region.
 
@@ -452,7 +669,7 @@ void W_ReleaseLumpNum(int lumpnum)
 
     lump = &lumpinfo[lumpnum];
 
-    if (lump->wad_file->mapped != NULL)
+    if (lump->wad_file->mapped != NULL && lump->compressed_size == 0)
     {
         // Memory-mapped file, so nothing needs to be done here.
     }
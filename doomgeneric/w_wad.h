@@ -44,6 +44,7 @@ struct lumpinfo_s
     wad_file_t *wad_file;
     int		position;
     int		size;
+    int		compressed_size;	// LZ4 data at position, 0 if stored
     void       *cache;
 
     // Used for hash table lookups
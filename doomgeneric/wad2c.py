@@ -0,0 +1,67 @@
+"""Convert a WAD file to C source, for linking it into the program.
+
+  python3 wad2c.py doom1.wad embedded_iwad.c
+
+Defines embedded_iwad[] and embedded_iwad_length for W_AddMemoryFile.
+Lumps are used in place, so the WAD is rewritten with every lump
+aligned: the asm.js build reads 32-bit fields with aligned loads only.
+A ZWAD from wadpack.py is already aligned and is copied as it is.
+"""
+
+import struct
+import sys
+
+ALIGN = 8
+
+
+def align(n):
+  return (n + ALIGN - 1) & ~(ALIGN - 1)
+
+
+def realign(data):
+  ident, count, offset = struct.unpack_from("<4sii", data, 0)
+  if ident == b"ZWAD":
+    return data
+  if ident not in (b"IWAD", b"PWAD"):
+    raise SystemExit("not a WAD file")
+
+  out = bytearray(data[:12])
+  directory = []
+  for i in range(count):
+    pos, size, name = struct.unpack_from("<ii8s", data, offset + 16 * i)
+    if size == 0:
+      directory.append((0, 0, name))
+      continue
+    out += bytes(align(len(out)) - len(out))
+    directory.append((len(out), size, name))
+    out += data[pos:pos + size]
+
+  out += bytes(align(len(out)) - len(out))
+  struct.pack_into("<i", out, 8, len(out))
+  for entry in directory:
+    out += struct.pack("<ii8s", *entry)
+  return bytes(out)
+
+
+def main():
+  if len(sys.argv) != 3:
+    raise SystemExit(__doc__)
+
+  with open(sys.argv[1], "rb") as f:
+    data = realign(f.read())
+
+  with open(sys.argv[2], "w") as f:
+    f.write("/* Generated by wad2c.py from %s; do not edit. */\n\n"
+            % sys.argv[1].replace("\\", "/").split("/")[-1])
+    f.write('#include "doomtype.h"\n\n')
+    f.write("#ifdef __GNUC__\n__attribute__((aligned(%d)))\n#endif\n" % ALIGN)
+    f.write("const byte embedded_iwad[] = {\n")
+    for i in range(0, len(data), 32):
+      f.write(",".join(str(b) for b in data[i:i + 32]))
+      f.write(",\n")
+    f.write("};\n\n")
+    f.write("const unsigned int embedded_iwad_length = %d;\n" % len(data))
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,109 @@
+"""Strip a WAD of the lumps a build can never use.
+
+  python3 wadmin.py --uses "demos" doom1.wad min/doom1.wad
+
+--uses lists the lump categories the build uses; lumps of the other
+categories are left out:
+
+  sound   DS* and DP* sound effects; needs FEATURE_SOUND
+  music   D_* songs and the GENMIDI, DMXGUS and DMXGUSC instruments;
+          needs FEATURE_SOUND
+  demos   DEMO1 to DEMO4: the title screen loop, -playdemo, -timedemo
+  endoom  ENDOOM, which I_Endoom only draws with ORIGCODE
+
+"make -f Makefile.pdfjs minwad" passes the categories its CFLAGS
+build in.  The engine plays no music for a missing song, skips
+missing demos in the title loop and skips a missing ENDOOM.  Lumps
+between *_START and *_END markers are graphics, so are always kept,
+as is DPHOOF, which D_DoomMain looks for to tell a registered IWAD.
+"""
+
+import struct
+import sys
+
+CATEGORIES = ("sound", "music", "demos", "endoom")
+
+KEEP = (b"DPHOOF",)
+
+
+def category(name):
+  if name in KEEP:
+    return None
+  if name.startswith((b"DS", b"DP")):
+    return "sound"
+  if name.startswith(b"D_") or name in (b"GENMIDI", b"DMXGUS", b"DMXGUSC"):
+    return "music"
+  if name in (b"DEMO1", b"DEMO2", b"DEMO3", b"DEMO4"):
+    return "demos"
+  if name == b"ENDOOM":
+    return "endoom"
+  return None
+
+
+def strip(data, uses):
+  ident, count, offset = struct.unpack_from("<4sii", data, 0)
+  if ident not in (b"IWAD", b"PWAD"):
+    raise SystemExit("not a WAD file")
+
+  out = bytearray(struct.pack("<4sii", ident, 0, 0))
+  directory = []
+  written = {}
+  removed = dict((c, [0, 0]) for c in CATEGORIES)
+  markers = 0
+
+  for i in range(count):
+    pos, size, name = struct.unpack_from("<ii8s", data, offset + 16 * i)
+    key = name.rstrip(b"\0").upper()
+
+    if key.endswith(b"_START"):
+      markers += 1
+    elif key.endswith(b"_END") and markers > 0:
+      markers -= 1
+    elif markers == 0:
+      c = category(key)
+      if c is not None and c not in uses:
+        removed[c][0] += 1
+        removed[c][1] += size
+        continue
+
+    # Lumps that share their data in the input share it in the output.
+    if size != 0 and (pos, size) not in written:
+      written[pos, size] = len(out)
+      out += data[pos:pos + size]
+    directory.append((written.get((pos, size), 0), size, name))
+
+  struct.pack_into("<ii", out, 4, len(directory), len(out))
+  for entry in directory:
+    out += struct.pack("<ii8s", *entry)
+  return bytes(out), removed
+
+
+def main():
+  args = sys.argv[1:]
+  if len(args) != 4 or args[0] != "--uses":
+    raise SystemExit(__doc__)
+
+  uses = args[1].replace(",", " ").split()
+  for c in uses:
+    if c not in CATEGORIES:
+      raise SystemExit("unknown lump category %s; expected one of: %s"
+                       % (c, " ".join(CATEGORIES)))
+
+  with open(args[2], "rb") as f:
+    data = f.read()
+
+  stripped, removed = strip(data, uses)
+
+  with open(args[3], "wb") as f:
+    f.write(stripped)
+
+  for c in CATEGORIES:
+    if removed[c][0]:
+      print("  %-6s %4d lumps, %8d bytes" % (c, removed[c][0], removed[c][1]))
+  print("%s: %d -> %d bytes, %d saved (%.1f%%)"
+        % (args[3], len(data), len(stripped), len(data) - len(stripped),
+           100.0 * (len(data) - len(stripped)) / len(data)))
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,141 @@
+"""Compress the lumps of a WAD file, for a smaller download.
+
+  python3 wadpack.py doom1.wad packed/doom1.wad
+
+Writes a "ZWAD": the WAD layout with a 20-byte directory entry that
+also holds each lump's compressed size.  Lumps are LZ4 block
+compressed one by one, so W_ReadLump decompresses only the lumps
+that are used, when they are first cached.  A lump that does not get
+smaller is stored as it is, with a compressed size of 0.  Lumps are
+aligned as by wad2c.py, so the output can also be linked in.
+"""
+
+import struct
+import sys
+
+ALIGN = 8
+
+MIN_MATCH = 4
+MAX_OFFSET = 65535
+
+# LZ4 block rules: the last match starts at least 12 bytes before the
+# end, and the last 5 bytes are always literals.
+MF_LIMIT = 12
+LAST_LITERALS = 5
+
+
+def align(n):
+  return (n + ALIGN - 1) & ~(ALIGN - 1)
+
+
+def put_length(out, n):
+  while n >= 255:
+    out.append(255)
+    n -= 255
+  out.append(n)
+
+
+def put_sequence(out, literals, match_len, offset):
+  lit = len(literals)
+  token = min(lit, 15) << 4
+  if match_len:
+    token |= min(match_len - MIN_MATCH, 15)
+  out.append(token)
+  if lit >= 15:
+    put_length(out, lit - 15)
+  out += literals
+  if match_len:
+    out += struct.pack("<H", offset)
+    if match_len - MIN_MATCH >= 15:
+      put_length(out, match_len - MIN_MATCH - 15)
+
+
+def compress(data):
+  """Greedy LZ4 block compression, hashing every 4-byte key."""
+  n = len(data)
+  out = bytearray()
+  table = {}
+  anchor = 0
+  i = 0
+  limit = n - MF_LIMIT
+
+  while i < limit:
+    key = data[i:i + MIN_MATCH]
+    candidate = table.get(key)
+    table[key] = i
+    if candidate is None or i - candidate > MAX_OFFSET:
+      i += 1
+      continue
+
+    length = MIN_MATCH
+    end = n - LAST_LITERALS
+    while i + length < end and data[candidate + length] == data[i + length]:
+      length += 1
+
+    put_sequence(out, data[anchor:i], length, i - candidate)
+    for j in range(i + 1, min(i + length, limit)):
+      table[data[j:j + MIN_MATCH]] = j
+    i += length
+    anchor = i
+
+  put_sequence(out, data[anchor:], 0, 0)
+  return bytes(out)
+
+
+def pack(data):
+  ident, count, offset = struct.unpack_from("<4sii", data, 0)
+  if ident not in (b"IWAD", b"PWAD"):
+    raise SystemExit("not a WAD file")
+
+  # The identification is replaced; the engine tells an IWAD from its
+  # lumps, not its header.
+  out = bytearray(struct.pack("<4sii", b"ZWAD", count, 0))
+  directory = []
+  written = {}
+  for i in range(count):
+    pos, size, name = struct.unpack_from("<ii8s", data, offset + 16 * i)
+    if size == 0:
+      directory.append((0, 0, 0, name))
+      continue
+
+    # Lumps that share their data in the input share it in the output.
+    if (pos, size) not in written:
+      lump = data[pos:pos + size]
+      packed = compress(lump)
+      out += bytes(align(len(out)) - len(out))
+      if len(packed) < size:
+        written[pos, size] = (len(out), len(packed))
+        out += packed
+      else:
+        written[pos, size] = (len(out), 0)
+        out += lump
+
+    filepos, compressed_size = written[pos, size]
+    directory.append((filepos, size, compressed_size, name))
+
+  out += bytes(align(len(out)) - len(out))
+  struct.pack_into("<i", out, 8, len(out))
+  for entry in directory:
+    out += struct.pack("<iii8s", *entry)
+  return bytes(out)
+
+
+def main():
+  if len(sys.argv) != 3:
+    raise SystemExit(__doc__)
+
+  with open(sys.argv[1], "rb") as f:
+    data = f.read()
+
+  packed = pack(data)
+
+  with open(sys.argv[2], "wb") as f:
+    f.write(packed)
+
+  print("%s: %d -> %d bytes (%.1f%%)"
+        % (sys.argv[2], len(data), len(packed),
+           100.0 * len(packed) / len(data)))
+
+
+if __name__ == "__main__":
+  main()
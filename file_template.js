@@ -1,28 +1,18 @@
-//https://stackoverflow.com/a/62364519
-function b64_to_uint8array(str) {
-  const abc = [..."ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"]; // base64 alphabet
-  let result = [];
-
-  for(let i=0; i<str.length/4; i++) {
-    let chunk = [...str.slice(4*i,4*i+4)]
-    let bin = chunk.map(x=> abc.indexOf(x).toString(2).padStart(6,0)).join(''); 
-    let bytes = bin.match(/.{1,8}/g).map(x=> +('0b'+x));
-    result.push(...bytes.slice(0,3 - (str[4*i+2]=="=") - (str[4*i+3]=="=")));
-  }
-  return new Uint8Array(result);
-}
-
-var file_data = b64_to_uint8array("__iwad_file__");
+// The WADs stay base64 text; pre.js decodes the ranges the engine
+// reads as it reads them.
+var file_b64 = "__iwad_file__";
 var file_name = "__iwad_filename__"
-var file2_data = b64_to_uint8array("__wad_file__");
+var file2_b64 = "__wad_file__";
 var file2_name = "__wad_filename__"
 
-if (file_data.length <= 9) {
-  throw "Error: IWAD not found.";
+// Placeholders left by embed_file.py, or builds with EMBED_IWAD that
+// link the IWAD into the program instead.
+if (file_b64.startsWith("__")) {
+  file_b64 = null;
 }
-if (file2_data.length <= 9) {
-  file2_data = null;
+if (file2_b64.startsWith("__")) {
+  file2_b64 = null;
 }
 else {
   Module.arguments = ["-file", file2_name];
-}
\ No newline at end of file
+}
@@ -1,7 +1,5 @@
 var Module = {};
 var lines = [];
-var pressed_keys = {};
-var key_queue = [];
 let frameCount = 0;
 
 
@@ -53,36 +51,77 @@ Module.printErr = function(msg) {
   print_msg(msg);
 }
 
+// ======================================================================
+// ============================= JS BRIDGE ==============================
+// ======================================================================
+
+// Block in the Module heap shared with js_bridge in doomgeneric_pdfjs.c:
+//   uint32 now; uint32 key_head; uint32 key_tail; uint16 keys[64];
+// JS writes the clock and appends key events, C reads them with plain
+// loads, so neither needs a call across the bridge.
+const KEY_RING_LEN = 64;
+let bridge = 0;
+
+// Typed keys are released one tick after the tick that saw the press.
+let release_pending = [];
+let release_due = [];
+
+function bridge_init(ptr) {
+  bridge = ptr;
+  bridge_set_time();
+}
+
+function bridge_set_time() {
+  Module.HEAPU32[bridge >> 2] = Date.now();
+}
+
+function bridge_push_key(doomkey, pressed) {
+  const u32 = Module.HEAPU32;
+  const head = u32[(bridge >> 2) + 1];
+
+  if (((head - u32[(bridge >> 2) + 2]) >>> 0) >= KEY_RING_LEN)
+    return; // full, C is not reading
+
+  Module.HEAPU16[((bridge + 12) >> 1) + head % KEY_RING_LEN] = (pressed << 8) | doomkey;
+  u32[(bridge >> 2) + 1] = head + 1;
+}
+
+// Called by the viewer's interval timer.
+function doom_tick() {
+  for (let i = 0; i < release_due.length; i++)
+    bridge_push_key(release_due[i], 0);
+  release_due = release_pending;
+  release_pending = [];
+
+  bridge_set_time();
+  _doomjs_tick();
+}
+
 function key_pressed(key_str) {
   if ("WASD".includes(key_str)) {
     key_str = key_str.toLowerCase();
     key_pressed("_") //placeholder for shift;
   }
-  let keycode = key_str.charCodeAt(0);
-  let doomkey = _key_to_doomkey(keycode);
-  print_msg("pressed: " + key_str + " " + keycode + " ");
+  let doomkey = _key_to_doomkey(key_str.charCodeAt(0));
   if (doomkey === -1) 
     return;
 
-  pressed_keys[doomkey] = 2;
+  bridge_push_key(doomkey, 1);
+  release_pending.push(doomkey);
 }
 
 function key_down(key_str) {
-  let keycode = key_str.charCodeAt(0);
-  let doomkey = _key_to_doomkey(keycode);
-  print_msg("key down: " + key_str + " " + keycode + " ");
+  let doomkey = _key_to_doomkey(key_str.charCodeAt(0));
   if (doomkey === -1) 
     return;
-  pressed_keys[doomkey] = 1;
+  bridge_push_key(doomkey, 1);
 }
 
 function key_up(key_str) {
-  let keycode = key_str.charCodeAt(0);
-  let doomkey = _key_to_doomkey(keycode);
-  print_msg("key up: " + key_str + " " + keycode + " ");
+  let doomkey = _key_to_doomkey(key_str.charCodeAt(0));
   if (doomkey === -1) 
     return;
-  pressed_keys[doomkey] = 0;
+  bridge_push_key(doomkey, 0);
 }
 
 function reset_input_box() {
@@ -90,10 +129,52 @@ function reset_input_box() {
 }
 app.setInterval("reset_input_box()", 1000);
 
-function write_file(filename, data) {
-  let stream = FS.open("/"+filename, "w+");
-  FS.write(stream, data, 0, data.length, 0);
-  FS.close(stream);
+// WAD files (file_template.js) stay base64 text. stream_read decodes
+// the byte range the engine asks for straight into the heap, so the
+// engine starts after decoding the directory, not the whole file.
+const B64_VALUES = new Uint8Array(128);
+for (let i = 0; i < 64; i++)
+  B64_VALUES["ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/".charCodeAt(i)] = i;
+
+let stream_files = [];
+
+// Writes the name of file index to name_ptr and returns its length
+// in bytes, or 0 if there is no such file.
+function stream_open(index, name_ptr, name_size) {
+  const b64 = index == 0 ? file_b64 : file2_b64;
+  const name = index == 0 ? file_name : file2_name;
+
+  if (!b64 || name.length >= name_size)
+    return 0;
+
+  for (let i = 0; i < name.length; i++)
+    Module.HEAPU8[name_ptr + i] = name.charCodeAt(i);
+  Module.HEAPU8[name_ptr + name.length] = 0;
+
+  stream_files[index] = b64;
+  return b64.length / 4 * 3 - (b64.endsWith("==") ? 2 : b64.endsWith("=") ? 1 : 0);
+}
+
+function stream_read(index, offset, ptr, len) {
+  const b64 = stream_files[index];
+  const heap = Module.HEAPU8;
+  const end = offset + len;
+  let pos = offset - offset % 3;
+
+  // Every 4 characters are 3 bytes; '=' padding decodes as 0 and
+  // falls past the end of the file, which W_Read never asks for.
+  for (let c = pos / 3 * 4; pos < end; c += 4, pos += 3) {
+    const n = B64_VALUES[b64.charCodeAt(c)] << 18 | B64_VALUES[b64.charCodeAt(c + 1)] << 12
+            | B64_VALUES[b64.charCodeAt(c + 2)] << 6 | B64_VALUES[b64.charCodeAt(c + 3)];
+
+    if (pos >= offset)
+      heap[ptr + pos - offset] = n >> 16;
+    if (pos + 1 >= offset && pos + 1 < end)
+      heap[ptr + pos + 1 - offset] = n >> 8 & 255;
+    if (pos + 2 < end)
+      heap[ptr + pos + 2 - offset] = n & 255;
+  }
+  return len;
 }
 
 // ======================================================================
@@ -101,25 +182,65 @@ function write_file(filename, data) {
 // ======================================================================
 
 
-function update_ascii_frame(buffer_ptr, buffer_size, width, height) {
-    const asciiBuffer = Module.HEAPU8.subarray(buffer_ptr, buffer_ptr + buffer_size);
-    let currentLine = '';
-  let lineNum = 0;
-  
-  if (frameCount % 10 === 0) {
-    print_msg("framebuffer size: " + buffer_size + " width: " + width + " height: " + height);
+// Rewrites the rows that changed since the last frame. Row N of the
+// UTF-8 text is at buffer_ptr + N * stride, and its length in bytes is
+// entry N of the int32 table at len_ptr. dirty_ptr holds dirty_count
+// int32 row numbers; height is the number of rows, for flipping them
+// onto the fields, whose numbers count up from the bottom.
+function update_ascii_frame(buffer_ptr, stride, len_ptr, dirty_ptr, dirty_count, height) {
+  const heap = Module.HEAPU8;
+  const table = Module.HEAP32;
+  const lens = len_ptr >> 2;
+
+  // Rows sit at a fixed stride, so each one is a single subarray
+  // decoded in one pass instead of a per-byte string build.
+  for (let i = 0, entry = dirty_ptr >> 2; i < dirty_count; i++, entry++) {
+    const row = table[entry];
+    const start = buffer_ptr + row * stride;
+    const currentLine = utf8_to_string(heap, start, start + table[lens + row]);
+    globalThis.getField("field_" + (height - row - 1)).value = currentLine;
   }
-    
-    for (let i = 0; i < asciiBuffer.length; i++) {
-        const byte = asciiBuffer[i];
-        if (byte === 10) { // '\n' character
-            globalThis.getField("field_" + (height - lineNum - 1)).value = currentLine;
-            currentLine = '';
-            lineNum++;
-        } else {
-            currentLine += String.fromCharCode(byte);
-        }
+
+  // The only call into JS per frame; bring the clock up to date so the
+  // frame pacing sees what output cost.
+  bridge_set_time();
+}
+
+// Rows hold UTF-8 glyphs (the shading blocks are 3 bytes each), so they
+// are decoded to UTF-16 code units before building the string.
+let utf8_units = new Uint16Array(0);
+
+function utf8_to_string(heap, start, end) {
+  if (utf8_units.length < end - start) {
+    utf8_units = new Uint16Array(end - start);
+  }
+
+  let n = 0;
+  for (let i = start; i < end;) {
+    const c = heap[i];
+    let cp;
+    if (c < 0x80) {
+      cp = c;
+      i += 1;
+    } else if (c < 0xe0) {
+      cp = ((c & 0x1f) << 6) | (heap[i + 1] & 0x3f);
+      i += 2;
+    } else if (c < 0xf0) {
+      cp = ((c & 0x0f) << 12) | ((heap[i + 1] & 0x3f) << 6) | (heap[i + 2] & 0x3f);
+      i += 3;
+    } else {
+      cp = ((c & 0x07) << 18) | ((heap[i + 1] & 0x3f) << 12) | ((heap[i + 2] & 0x3f) << 6) | (heap[i + 3] & 0x3f);
+      i += 4;
+    }
+    if (cp > 0xffff) {
+      cp -= 0x10000;
+      utf8_units[n++] = 0xd800 | (cp >> 10);
+      cp = 0xdc00 | (cp & 0x3ff);
     }
+    utf8_units[n++] = cp;
+  }
+
+  return String.fromCharCode.apply(null, utf8_units.subarray(0, n));
 }
 
 // New optimized framebuffer rendering (no c-optimizations)